@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Language of a lang-string key that is typed on whatever language is currently active
+#define LANG_ANY 0xFF
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_language_state_changed {
+    uint8_t state;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(zmk_language_state_changed);
+
+static inline int raise_language_state_changed(uint8_t state) {
+    return raise_zmk_language_state_changed(
+        (struct zmk_language_state_changed){.state = state, .timestamp = k_uptime_get()});
+}
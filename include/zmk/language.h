@@ -8,5 +8,30 @@
 
 #include <stdint.h>
 
-extern uint8_t current_language_state;
-uint8_t zmk_language_state();
\ No newline at end of file
+// Counters of one behavior instance, each behavior only uses its own fields
+struct zmk_language_stats {
+    // Language switches performed by lang-switch and the hotkey taps injected for them
+    uint32_t switches;
+    uint32_t injected_taps;
+    // Temporary switches started by kp-on-lang and keys it remapped instead of switching
+    uint32_t kp_on_lang_switches;
+    uint32_t kp_on_lang_remaps;
+    // Positions redirected to the target layer by sticky-key-layer and layer states restored
+    uint32_t sticky_interceptions;
+    uint32_t sticky_layer_restores;
+};
+
+// Lists an instance's counters in `lang stats` under the device name, called from its init
+void zmk_language_stats_register(const char *name, struct zmk_language_stats *stats);
+
+// param2 flag for lang-switch bindings invoked by other behaviors: keys queued right after the
+// switch depend on its language, so later switches must not be coalesced with it
+#define ZMK_LANGUAGE_SWITCH_PINNED 0x1
+
+// Language of the currently selected endpoint (USB or BLE profile)
+uint8_t zmk_language_state();
+void zmk_language_set_state(uint8_t lang);
+int zmk_language_load_state();
+// Languages known to a lang-switch instance; stored states outside the smallest count are reset
+void zmk_language_limit_count(uint8_t count);
+void zmk_language_stats_reset();
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+enum zmk_language_trace_type {
+    // Language switch requested, position of the pressing key
+    ZMK_LANGUAGE_TRACE_SWITCH,
+    // Switch hotkey tap sent to the host, or a step dropped because the host was already there
+    ZMK_LANGUAGE_TRACE_TAP,
+    ZMK_LANGUAGE_TRACE_TAP_SKIPPED,
+    // kp-on-lang key pressed, sent remapped without switching, and its language switched back
+    ZMK_LANGUAGE_TRACE_KP_ON_LANG,
+    ZMK_LANGUAGE_TRACE_KP_ON_LANG_REMAP,
+    ZMK_LANGUAGE_TRACE_KP_ON_LANG_SWITCH_BACK,
+    // Keycode press reaching the HID report, position holds the keycode
+    ZMK_LANGUAGE_TRACE_KEY,
+    // sticky-key-layer position redirected to the target layer, and layer state restored
+    ZMK_LANGUAGE_TRACE_STICKY_INTERCEPT,
+    ZMK_LANGUAGE_TRACE_STICKY_RESTORE,
+};
+
+struct zmk_language_trace_record {
+    // Lower 32 bits of the uptime in microseconds
+    uint32_t timestamp_us;
+    uint32_t position;
+    uint8_t type;
+    uint8_t language;
+    uint8_t layer;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_LANGUAGE_TRACE)
+void zmk_language_trace(enum zmk_language_trace_type type, uint32_t position);
+// Number of records currently held, and the record at index (0 is the oldest)
+size_t zmk_language_trace_count();
+const struct zmk_language_trace_record *zmk_language_trace_at(size_t index);
+void zmk_language_trace_clear();
+#else
+static inline void zmk_language_trace(enum zmk_language_trace_type type, uint32_t position) {}
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_LANGUAGE_LISTENER_TIMING)
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+static inline uint32_t zmk_language_listener_cycles(void) {
+#if IS_ENABLED(CONFIG_ARCH_POSIX) && (defined(__x86_64__) || defined(__i386__))
+    // Simulated time stands still while a listener runs, count host cycles instead
+    return (uint32_t)__builtin_ia32_rdtsc();
+#else
+    return k_cycle_get_32();
+#endif
+}
+
+// Event listener that prints `lang_listener,<mod>,<cycles>` for every call, see tests/run-tests.sh
+#define ZMK_LANGUAGE_LISTENER(mod, cb)                                                             \
+    static int mod##_timed(const zmk_event_t *eh) {                                                \
+        const uint32_t start = zmk_language_listener_cycles();                                     \
+        const int ret = cb(eh);                                                                    \
+        printk("lang_listener," #mod ",%u\n", zmk_language_listener_cycles() - start);             \
+        return ret;                                                                                \
+    }                                                                                              \
+    ZMK_LISTENER(mod, mod##_timed)
+#else
+#define ZMK_LANGUAGE_LISTENER(mod, cb) ZMK_LISTENER(mod, cb)
+#endif
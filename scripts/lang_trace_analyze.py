@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""Latency analysis for the language trace buffer.
+
+Feed it the output of the `lang trace` shell command (a console log with other lines mixed in is
+fine). Every key press that needs language handling (a language switch, a press-on-lang key, a
+sticky-key-layer interception or a press-on-lang switch back) starts an episode, and the episode's
+latency is the time from that press to the last tap or key sent to the host before the next
+episode starts.
+
+    python3 scripts/lang_trace_analyze.py console.log
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+# Must match enum zmk_language_trace_type in include/zmk/language_trace.h
+SWITCH = 0
+TAP = 1
+TAP_SKIPPED = 2
+KP_ON_LANG = 3
+KP_ON_LANG_REMAP = 4
+KP_ON_LANG_SWITCH_BACK = 5
+KEY = 6
+STICKY_INTERCEPT = 7
+STICKY_RESTORE = 8
+
+TRIGGER_NAMES = {
+    SWITCH: "lang_switch",
+    KP_ON_LANG: "kp_on_lang",
+    KP_ON_LANG_SWITCH_BACK: "kp_on_lang_switch_back",
+    STICKY_INTERCEPT: "sticky_intercept",
+}
+OUTPUTS = (TAP, KEY)
+
+RECORD = re.compile(r"(\d+),(\d+),(\d+),(\d+),(\d+)\s*$")
+
+
+def parse(lines):
+    for line in lines:
+        match = RECORD.search(line)
+        if match:
+            yield tuple(int(field) for field in match.groups())
+
+
+def elapsed_us(start, end):
+    # Timestamps are the lower 32 bits of the uptime in microseconds
+    return (end - start) & 0xFFFFFFFF
+
+
+class Episode:
+    def __init__(self, kind, position, timestamp):
+        self.kind = kind
+        self.position = position
+        self.start = timestamp
+        self.last_output = None
+        self.taps = 0
+        self.skipped = 0
+        self.remapped = False
+
+
+def episodes(records):
+    current = None
+    for timestamp, kind, position, _language, _layer in records:
+        if kind in TRIGGER_NAMES:
+            # A press-on-lang key or switch back invokes the language switch itself
+            if (
+                kind == SWITCH
+                and current is not None
+                and current.kind != SWITCH
+                and current.position == position
+            ):
+                continue
+            if current is not None:
+                yield current
+            current = Episode(kind, position, timestamp)
+        elif current is None:
+            continue
+        elif kind in OUTPUTS:
+            current.last_output = timestamp
+            current.taps += kind == TAP
+        elif kind == TAP_SKIPPED:
+            current.skipped += 1
+        elif kind == KP_ON_LANG_REMAP:
+            current.remapped = True
+    if current is not None:
+        yield current
+
+
+def percentile(values, fraction):
+    index = min(len(values) - 1, int(round(fraction * (len(values) - 1))))
+    return values[index]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "trace", nargs="?", type=argparse.FileType("r"), default=sys.stdin,
+        help="`lang trace` output, stdin by default",
+    )
+    args = parser.parse_args()
+
+    latencies = defaultdict(list)
+    taps = defaultdict(int)
+    skipped = defaultdict(int)
+    remapped = defaultdict(int)
+    for episode in episodes(parse(args.trace)):
+        name = TRIGGER_NAMES[episode.kind]
+        taps[name] += episode.taps
+        skipped[name] += episode.skipped
+        remapped[name] += episode.remapped
+        latencies[name].append(
+            0 if episode.last_output is None else elapsed_us(episode.start, episode.last_output)
+        )
+
+    if not latencies:
+        print("no trace records found", file=sys.stderr)
+        return 1
+
+    header = ("episode", "count", "min_us", "p50_us", "p90_us", "p99_us", "max_us", "taps",
+              "skipped", "remapped")
+    print("{:<24}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}{:>8}{:>9}{:>10}".format(*header))
+    for name in sorted(latencies):
+        values = sorted(latencies[name])
+        print("{:<24}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}{:>8}{:>9}{:>10}".format(
+            name, len(values), values[0], percentile(values, 0.5), percentile(values, 0.9),
+            percentile(values, 0.99), values[-1], taps[name], skipped[name], remapped[name]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -7,27 +7,91 @@
 #define DT_DRV_COMPAT zmk_behavior_kp_on_lang
 
 #include <stdlib.h>
+#include <string.h>
 #include <zephyr/device.h>
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 
 #include <zmk/keymap.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
+#include <zmk/hid.h>
 #include <zmk/language.h>
+#include <zmk/language_trace.h>
+#include <zmk/event_manager.h>
 #include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/position_state_changed.h>
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_DECLARE(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
+
+#define KEY_PRESS DEVICE_DT_NAME(DT_INST(0, zmk_behavior_key_press))
+#define TRANSPARENT DEVICE_DT_NAME(DT_INST(0, zmk_behavior_transparent))
+
+#define ZMK_BHV_KP_ON_LANG_MAX_HELD 10
+#define ZMK_BHV_KP_ON_LANG_POSITION_FREE UINT32_MAX
+#define ZMK_BHV_KP_ON_LANG_MAX_CAPTURED_EVENTS 40
+
+// param2 of the marker queued behind switch taps, see settle_switch()
+#define KP_ON_LANG_SETTLED 1
 
 struct behavior_kp_on_lang_config {
     struct zmk_behavior_binding switch_behavior;
+    uint32_t switch_back_delay_ms;
+    // <LANG SYMBOL KEYCODE> triples: SYMBOL is produced by KEYCODE while the host is on LANG
+    const uint32_t *remap;
+    size_t remap_len;
+    // Layers that keep the language switched for as long as any of them is active
+    uint32_t hold_layers;
+    struct zmk_language_stats *stats;
 };
 
 struct behavior_kp_on_lang_data {
-    bool switch_back;
+    // Active layers out of hold_layers, and whether they took a reference on the hold
+    uint32_t active_hold_layers;
+    bool layers_hold_lang;
+};
+
+struct active_kp_on_lang {
+    uint32_t position;
+    // Keycode sent on press, remapped or not, so the release matches it
+    uint32_t keycode;
+    // This press holds a reference on the temporary language
+    bool holds_lang;
+};
+
+// Temporary language shared by all overlapping kp_on_lang presses. It is switched to by the
+// first press and switched back from once the last reference is gone.
+struct kp_on_lang_hold {
+    bool active;
+    uint8_t lang;
+    uint8_t refs;
+    // Taken by an instance with hold layers, keys are held back behind its switch back
+    bool settles;
     struct zmk_behavior_binding switch_back_behavior;
+    struct zmk_behavior_binding_event switch_back_event;
 };
 
-static int behavior_kp_on_lang_init(const struct device *dev) { return 0; };
+static struct active_kp_on_lang active_kp_on_langs[ZMK_BHV_KP_ON_LANG_MAX_HELD] = {};
+static struct kp_on_lang_hold hold = {};
+static struct k_work_delayable switch_back_work;
+// A switch was invoked that settle_switch() has not handled yet, whether keys are to be held back
+// behind it, and whether it includes a switch back
+static bool switch_invoked;
+static bool switch_holds_back;
+static bool switched_back;
+// Markers still in the behavior queue, and those of them behind a switch back. Keys typed right
+// after a switch are held back while any is, so they are not sent ahead of its paced taps.
+static uint8_t pending_markers;
+static uint8_t pending_back_markers;
+static struct zmk_position_state_changed_event
+    captured_events[ZMK_BHV_KP_ON_LANG_MAX_CAPTURED_EVENTS] = {};
+static uint8_t captured_events_len;
+
+#define KP_ON_LANG_DEVICE_REF(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const kp_on_lang_devices[] = {
+    DT_INST_FOREACH_STATUS_OKAY(KP_ON_LANG_DEVICE_REF)};
 
 struct zmk_behavior_binding get_switch_back_binding(uint8_t target_lang,
                                                     const struct zmk_behavior_binding *original) {
@@ -37,46 +101,459 @@ struct zmk_behavior_binding get_switch_back_binding(uint8_t target_lang,
     return copy;
 }
 
+static struct active_kp_on_lang *store_kp_on_lang(uint32_t position, uint32_t keycode) {
+    for (int i = 0; i < ZMK_BHV_KP_ON_LANG_MAX_HELD; i++) {
+        struct active_kp_on_lang *const press = &active_kp_on_langs[i];
+        if (press->position != ZMK_BHV_KP_ON_LANG_POSITION_FREE) {
+            continue;
+        }
+        press->position = position;
+        press->keycode = keycode;
+        press->holds_lang = false;
+        return press;
+    }
+    return NULL;
+}
+
+static struct active_kp_on_lang *find_kp_on_lang(uint32_t position) {
+    for (int i = 0; i < ZMK_BHV_KP_ON_LANG_MAX_HELD; i++) {
+        if (active_kp_on_langs[i].position == position) {
+            return &active_kp_on_langs[i];
+        }
+    }
+    return NULL;
+}
+
+static bool find_remap(const struct behavior_kp_on_lang_config *config, uint8_t lang,
+                       uint32_t symbol, uint32_t *keycode) {
+    for (size_t i = 0; i + 2 < config->remap_len; i += 3) {
+        if (config->remap[i] == lang && config->remap[i + 1] == symbol) {
+            *keycode = config->remap[i + 2];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the language the host is left on once the switch back, if any, has been sent
+static uint8_t end_hold(void) {
+    if (!hold.active) {
+        return zmk_language_state();
+    }
+    k_work_cancel_delayable(&switch_back_work);
+    hold.active = false;
+    hold.refs = 0;
+    for (int i = 0; i < ZMK_BHV_KP_ON_LANG_MAX_HELD; i++) {
+        active_kp_on_langs[i].holds_lang = false;
+    }
+    for (int i = 0; i < ARRAY_SIZE(kp_on_lang_devices); i++) {
+        struct behavior_kp_on_lang_data *data = kp_on_lang_devices[i]->data;
+        data->layers_hold_lang = false;
+    }
+
+    if (zmk_language_state() != hold.lang) {
+        // Language was switched explicitly in the meantime, nothing to restore
+        LOG_DBG("KP_LANG dropping switch back, language changed to %d", zmk_language_state());
+        return zmk_language_state();
+    }
+    LOG_DBG("KP_LANG switch back to %d", hold.switch_back_behavior.param1);
+    zmk_language_trace(ZMK_LANGUAGE_TRACE_KP_ON_LANG_SWITCH_BACK, hold.switch_back_event.position);
+    zmk_behavior_invoke_binding(&hold.switch_back_behavior, hold.switch_back_event, true);
+    zmk_behavior_invoke_binding(&hold.switch_back_behavior, hold.switch_back_event, false);
+    switch_invoked = true;
+    switch_holds_back |= hold.settles;
+    switched_back = true;
+    return hold.switch_back_behavior.param1;
+}
+
+static bool acquire_hold(const struct behavior_kp_on_lang_config *config,
+                         struct zmk_behavior_binding_event *event) {
+    const uint8_t target_lang = config->switch_behavior.param1;
+
+    // The switch back of a superseded hold may still be waiting in the behavior queue, so the
+    // language to return to is the one it restores rather than the current state
+    uint8_t current_lang = zmk_language_state();
+    if (hold.active) {
+        if (hold.lang == target_lang) {
+            // Already on our language, either held by another press or lingering
+            k_work_cancel_delayable(&switch_back_work);
+            hold.refs++;
+            LOG_DBG("KP_LANG reusing language %d, refs %d", target_lang, hold.refs);
+            return true;
+        }
+        current_lang = end_hold();
+    }
+
+    if (current_lang == target_lang) {
+        return false;
+    }
+    LOG_DBG("KP_LANG switch from %d to %d", current_lang, target_lang);
+    config->stats->kp_on_lang_switches++;
+    hold.active = true;
+    hold.lang = target_lang;
+    hold.refs = 1;
+    hold.settles = config->hold_layers != 0;
+    hold.switch_back_behavior = get_switch_back_binding(current_lang, &config->switch_behavior);
+    LOG_DBG("KP_LANG switchback %d", hold.switch_back_behavior.param1);
+    // Invoked directly so that the switch taps are queued ahead of our key, pinned so that a
+    // later switch cannot cancel them before the key is sent
+    struct zmk_behavior_binding switch_binding = config->switch_behavior;
+    switch_binding.param2 = ZMK_LANGUAGE_SWITCH_PINNED;
+    zmk_behavior_invoke_binding(&switch_binding, *event, true);
+    zmk_behavior_invoke_binding(&switch_binding, *event, false);
+    switch_invoked = true;
+    switch_holds_back |= config->hold_layers != 0;
+    return true;
+}
+
+static bool end_linger(const struct zmk_position_state_changed *ev);
+
+// Releases the captured positions in order, all of them when flushing or until one switches again
+// otherwise, its marker then holds back the rest
+static void release_captured_positions(bool flush) {
+    while ((flush || pending_markers == 0) && captured_events_len > 0) {
+        if (!flush && captured_events[0].data.state && end_linger(&captured_events[0].data)) {
+            // Held back behind one switch and now ending the linger that followed it, the switch
+            // back holds it back once more
+            continue;
+        }
+        struct zmk_position_state_changed_event ev = captured_events[0];
+        captured_events_len--;
+        memmove(&captured_events[0], &captured_events[1],
+                captured_events_len * sizeof(captured_events[0]));
+        LOG_DBG("KP_LANG releasing captured position %d", ev.data.position);
+        ZMK_EVENT_RELEASE(ev);
+    }
+}
+
+// Queues a marker behind the taps of the last switch and any key queued after them, if keys are to
+// be held back behind it. Positions pressed until it comes out of the queue are captured, see
+// kp_on_lang_position_state_changed(). When the queue is idle the marker runs right away.
+static void settle_switch(struct zmk_behavior_binding_event *event) {
+    if (!switch_invoked) {
+        return;
+    }
+    const bool back = switched_back;
+    const bool holds_back = switch_holds_back;
+    switch_invoked = false;
+    switch_holds_back = false;
+    switched_back = false;
+    if (!holds_back) {
+        // Press-on-lang keys are queued behind the taps themselves
+        return;
+    }
+    const struct zmk_behavior_binding marker = {
+        .behavior_dev = DEVICE_DT_NAME(DT_DRV_INST(0)),
+        .param1 = back,
+        .param2 = KP_ON_LANG_SETTLED,
+    };
+    pending_markers++;
+    pending_back_markers += back;
+    if (zmk_behavior_queue_add(event, marker, true, 0) < 0) {
+        LOG_ERR("KP_LANG behavior queue full, keys are not held back for the switch");
+        pending_markers--;
+        pending_back_markers -= back;
+        release_captured_positions(false);
+    }
+}
+
+static void switch_settled(bool back) {
+    if (pending_markers > 0) {
+        pending_markers--;
+    }
+    if (back && pending_back_markers > 0) {
+        pending_back_markers--;
+    }
+    release_captured_positions(false);
+}
+
+static void release_hold(const struct behavior_kp_on_lang_config *config,
+                         struct zmk_behavior_binding_event *event) {
+    if (!hold.active || hold.refs == 0 || --hold.refs > 0) {
+        return;
+    }
+    hold.switch_back_event = *event;
+    if (config->switch_back_delay_ms > 0) {
+        // Linger on the language in case more symbols for it follow
+        k_work_reschedule(&switch_back_work, K_MSEC(config->switch_back_delay_ms));
+    } else {
+        end_hold();
+    }
+}
+
+static void switch_back_work_handler(struct k_work *work) {
+    LOG_DBG("KP_LANG switch back delay expired");
+    if (hold.refs == 0) {
+        end_hold();
+        settle_switch(&hold.switch_back_event);
+    }
+}
+
+static int behavior_kp_on_lang_init(const struct device *dev) {
+    const struct behavior_kp_on_lang_config *config = dev->config;
+    zmk_language_stats_register(dev->name, config->stats);
+
+    static bool init_first_run = true;
+    if (init_first_run) {
+        k_work_init_delayable(&switch_back_work, switch_back_work_handler);
+        for (int i = 0; i < ZMK_BHV_KP_ON_LANG_MAX_HELD; i++) {
+            active_kp_on_langs[i].position = ZMK_BHV_KP_ON_LANG_POSITION_FREE;
+        }
+    }
+    init_first_run = false;
+    return 0;
+};
+
+// The key goes through the behavior queue as well, so it is sent after any paced switch taps
+static int queue_key(uint32_t keycode, struct zmk_behavior_binding_event *event, bool pressed) {
+    const struct zmk_behavior_binding key_binding = {
+        .behavior_dev = KEY_PRESS,
+        .param1 = keycode,
+    };
+    return zmk_behavior_queue_add(event, key_binding, pressed, 0);
+}
+
 static int kp_on_lang_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                              struct zmk_behavior_binding_event event) {
+    if (binding->param2 == KP_ON_LANG_SETTLED) {
+        switch_settled(binding->param1);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
     const struct behavior_kp_on_lang_config *config = dev->config;
-    struct behavior_kp_on_lang_data *data = dev->data;
 
-    const uint8_t current_lang = zmk_language_state();
-    if (current_lang != binding->param2) {
-        LOG_DBG("KP_LANG switch from %d to %d", current_lang, config->switch_behavior.param1);
-        data->switch_back_behavior =
-            get_switch_back_binding(current_lang, &config->switch_behavior);
-        data->switch_back = true;
-        LOG_DBG("KP_LANG switchback %d", data->switch_back_behavior.param1);
-        zmk_behavior_queue_add(&event, config->switch_behavior, true, 0);
-        zmk_behavior_queue_add(&event, config->switch_behavior, false, 0);
+    const uint8_t target_lang = config->switch_behavior.param1;
+    uint32_t keycode = binding->param1;
+    zmk_language_trace(ZMK_LANGUAGE_TRACE_KP_ON_LANG, event.position);
+    bool remapped = false;
+    if (!hold.active || hold.lang != target_lang) {
+        // A hold for another language is superseded by this press either way, end it first so
+        // the remap is looked up for the language the host is actually on
+        end_hold();
+        const uint8_t current_lang = zmk_language_state();
+        remapped = current_lang != target_lang &&
+                   find_remap(config, current_lang, binding->param1, &keycode);
+    }
+
+    struct active_kp_on_lang *press = store_kp_on_lang(event.position, keycode);
+    if (press == NULL) {
+        LOG_ERR("KP_LANG unable to store press, did you press more than %d kp_on_lang?",
+                ZMK_BHV_KP_ON_LANG_MAX_HELD);
+    } else if (remapped) {
+        LOG_DBG("KP_LANG 0x%08X remapped to 0x%08X, no switch needed", binding->param1, keycode);
+        config->stats->kp_on_lang_remaps++;
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_KP_ON_LANG_REMAP, event.position);
+    } else {
+        press->holds_lang = acquire_hold(config, &event);
     }
-    return raise_zmk_keycode_state_changed_from_encoded(binding->param1, true, event.timestamp);
+    queue_key(keycode, &event, true);
+    settle_switch(&event);
+    return ZMK_BEHAVIOR_OPAQUE;
 }
 
 static int kp_on_lang_keymap_binding_released(struct zmk_behavior_binding *binding,
                                               struct zmk_behavior_binding_event event) {
+    if (binding->param2 == KP_ON_LANG_SETTLED) {
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
-    struct behavior_kp_on_lang_data *data = dev->data;
+    const struct behavior_kp_on_lang_config *config = dev->config;
 
-    if (data->switch_back) {
-        zmk_behavior_queue_add(&event, data->switch_back_behavior, true, 0);
-        zmk_behavior_queue_add(&event, data->switch_back_behavior, false, 0);
-        data->switch_back = false;
+    struct active_kp_on_lang *press = find_kp_on_lang(event.position);
+    queue_key(press != NULL ? press->keycode : binding->param1, &event, false);
+    if (press != NULL) {
+        const bool holds_lang = press->holds_lang;
+        press->position = ZMK_BHV_KP_ON_LANG_POSITION_FREE;
+        if (holds_lang) {
+            release_hold(config, &event);
+        }
     }
-    return raise_zmk_keycode_state_changed_from_encoded(binding->param1, false, event.timestamp);
+    settle_switch(&event);
+    return ZMK_BEHAVIOR_OPAQUE;
 }
 
 static const struct behavior_driver_api behavior_kp_on_lang_driver_api = {
     .binding_pressed = kp_on_lang_keymap_binding_pressed,
     .binding_released = kp_on_lang_keymap_binding_released};
 
+static int kp_on_lang_keycode_state_changed(const struct zmk_keycode_state_changed *ev) {
+    if (ev->state) {
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_KEY, ev->keycode);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+// Hold layers switch the language once on activation and back once on deactivation, taking the
+// same shared hold as a held key so plain &kp keys on the layer need no switching of their own
+static int kp_on_lang_layer_state_changed(const struct zmk_layer_state_changed *ev) {
+    for (int i = 0; i < ARRAY_SIZE(kp_on_lang_devices); i++) {
+        const struct behavior_kp_on_lang_config *config = kp_on_lang_devices[i]->config;
+        struct behavior_kp_on_lang_data *data = kp_on_lang_devices[i]->data;
+        if ((config->hold_layers & BIT(ev->layer)) == 0) {
+            continue;
+        }
+
+        const uint32_t was_active = data->active_hold_layers;
+        WRITE_BIT(data->active_hold_layers, ev->layer, ev->state);
+        struct zmk_behavior_binding_event event = {
+            .position = 0,
+            .timestamp = ev->timestamp,
+        };
+        if (was_active == 0 && data->active_hold_layers != 0) {
+            LOG_DBG("KP_LANG layer %d activated, holding language %d", ev->layer,
+                    config->switch_behavior.param1);
+            data->layers_hold_lang = acquire_hold(config, &event);
+        } else if (was_active != 0 && data->active_hold_layers == 0 && data->layers_hold_lang) {
+            LOG_DBG("KP_LANG layer %d deactivated, releasing language", ev->layer);
+            data->layers_hold_lang = false;
+            release_hold(config, &event);
+        }
+        settle_switch(&event);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+// Binding the keymap resolves a position to, from the highest active layer down, and its layer
+static const struct zmk_behavior_binding *position_binding(uint32_t position,
+                                                           zmk_keymap_layer_id_t *layer_id) {
+    for (int layer = ZMK_KEYMAP_LAYERS_LEN - 1; layer >= zmk_keymap_layer_default(); layer--) {
+        if (!zmk_keymap_layer_active(layer)) {
+            continue;
+        }
+        const struct zmk_behavior_binding *binding =
+            zmk_keymap_get_layer_binding_at_idx(layer, position);
+        if (binding != NULL && binding->behavior_dev != NULL &&
+            strcmp(binding->behavior_dev, TRANSPARENT) != 0) {
+            *layer_id = layer;
+            return binding;
+        }
+    }
+    return NULL;
+}
+
+static bool is_kp_on_lang(const struct zmk_behavior_binding *binding) {
+    for (int i = 0; i < ARRAY_SIZE(kp_on_lang_devices); i++) {
+        if (strcmp(binding->behavior_dev, kp_on_lang_devices[i]->name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Any key but a press-on-lang one ends the burst. The switch back is sent before the position
+// reaches the keymap, so whatever the key types follows it in order, whether it is sent right away
+// or played from the behavior queue by a macro or lang-string.
+static bool end_linger(const struct zmk_position_state_changed *ev) {
+    if (!hold.active || hold.refs > 0) {
+        return false;
+    }
+    zmk_keymap_layer_id_t layer;
+    const struct zmk_behavior_binding *binding = position_binding(ev->position, &layer);
+    if (binding != NULL && is_kp_on_lang(binding)) {
+        // Reuses or supersedes the hold itself when pressed
+        return false;
+    }
+    LOG_DBG("KP_LANG position %d pressed while lingering, switching back", ev->position);
+    end_hold();
+    // The position is held back whichever instance switched
+    switch_holds_back = true;
+    struct zmk_behavior_binding_event event = {
+        .position = ev->position,
+        .timestamp = ev->timestamp,
+    };
+    settle_switch(&event);
+    return true;
+}
+
+static bool on_hold_layer(zmk_keymap_layer_id_t layer) {
+    for (int i = 0; i < ARRAY_SIZE(kp_on_lang_devices); i++) {
+        const struct behavior_kp_on_lang_config *config = kp_on_lang_devices[i]->config;
+        if (config->hold_layers & BIT(layer)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// After a switch back every key waits for it. After a switch to the language of a hold layer only
+// the keys bound on that layer do, keys falling through it are not typed on that language anyway.
+// Once one position is held back, all later ones are too, so that none overtakes it.
+static bool holds_back_position(const struct zmk_position_state_changed *ev) {
+    if (captured_events_len > 0 || pending_back_markers > 0) {
+        return true;
+    }
+    zmk_keymap_layer_id_t layer;
+    return ev->state && position_binding(ev->position, &layer) != NULL && on_hold_layer(layer);
+}
+
+// Positions never come out of the behavior queue, so holding them back keeps plain keys, e.g. &kp
+// on a hold layer, behind queued switch taps without reordering keys sent by macros
+static int kp_on_lang_position_state_changed(const struct zmk_position_state_changed *ev) {
+    if (ev->state) {
+        end_linger(ev);
+    }
+    if (pending_markers == 0 || !holds_back_position(ev)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    if (captured_events_len == ARRAY_SIZE(captured_events)) {
+        // Sent ahead of the switch taps, but at least in the order they were pressed
+        LOG_ERR("KP_LANG too many keys pressed during a switch, releasing the held back ones");
+        release_captured_positions(true);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    LOG_DBG("KP_LANG capturing position %d until the switch taps are sent", ev->position);
+    captured_events[captured_events_len++] = copy_raised_zmk_position_state_changed(ev);
+    return ZMK_EV_EVENT_CAPTURED;
+}
+
+static int kp_on_lang_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *keycode_ev = as_zmk_keycode_state_changed(eh);
+    if (keycode_ev != NULL) {
+        return kp_on_lang_keycode_state_changed(keycode_ev);
+    }
+
+    const struct zmk_layer_state_changed *layer_ev = as_zmk_layer_state_changed(eh);
+    if (layer_ev != NULL) {
+        return kp_on_lang_layer_state_changed(layer_ev);
+    }
+
+    const struct zmk_position_state_changed *position_ev = as_zmk_position_state_changed(eh);
+    if (position_ev != NULL) {
+        return kp_on_lang_position_state_changed(position_ev);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LANGUAGE_LISTENER(behavior_kp_on_lang, kp_on_lang_listener);
+ZMK_SUBSCRIPTION(behavior_kp_on_lang, zmk_keycode_state_changed);
+ZMK_SUBSCRIPTION(behavior_kp_on_lang, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION(behavior_kp_on_lang, zmk_position_state_changed);
+
+#define KP_ON_LANG_BIT(node_id, prop, idx) | BIT(DT_PROP_BY_IDX(node_id, prop, idx))
+#define KP_ON_LANG_HOLD_LAYERS(n)                                                                  \
+    COND_CODE_1(DT_INST_NODE_HAS_PROP(n, hold_layers),                                             \
+                ((0 DT_INST_FOREACH_PROP_ELEM(n, hold_layers, KP_ON_LANG_BIT))), (0))
+
+// Only emitted when the instance has a remap, an empty initializer would be a zero-length array
+#define KP_ON_LANG_REMAP_TABLE(n)                                                                  \
+    COND_CODE_1(DT_INST_NODE_HAS_PROP(n, remap),                                                   \
+                (static const uint32_t behavior_kp_on_lang_remap_##n[] = DT_INST_PROP(n, remap);), \
+                ())
+
 #define KP_ON_LANG_INST(n)                                                                         \
-    static struct behavior_kp_on_lang_data behavior_kp_on_lang_data_##n = {.switch_back = false};  \
+    BUILD_ASSERT(DT_INST_PROP_LEN_OR(n, remap, 0) % 3 == 0,                                        \
+                 "remap must be a list of <LANG SYMBOL KEYCODE> triples");                         \
+    KP_ON_LANG_REMAP_TABLE(n)                                                                      \
+    static struct behavior_kp_on_lang_data behavior_kp_on_lang_data_##n = {};                      \
+    static struct zmk_language_stats behavior_kp_on_lang_stats_##n = {};                           \
     static struct behavior_kp_on_lang_config behavior_kp_on_lang_config_##n = {                    \
         .switch_behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, DT_DRV_INST(n)),                          \
+        .switch_back_delay_ms = DT_INST_PROP(n, switch_back_delay_ms),                             \
+        .remap = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, remap), (behavior_kp_on_lang_remap_##n),     \
+                             (NULL)),                                                              \
+        .remap_len = DT_INST_PROP_LEN_OR(n, remap, 0),                                             \
+        .hold_layers = KP_ON_LANG_HOLD_LAYERS(n),                                                  \
+        .stats = &behavior_kp_on_lang_stats_##n,                                                   \
     };                                                                                             \
     BEHAVIOR_DT_INST_DEFINE(n, behavior_kp_on_lang_init, NULL, &behavior_kp_on_lang_data_##n,      \
                             &behavior_kp_on_lang_config_##n, APPLICATION,                          \
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_lang_string
+
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+
+#include <dt-bindings/zmk/lang.h>
+#include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
+#include <zmk/language.h>
+
+LOG_MODULE_DECLARE(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+#define KEY_PRESS DEVICE_DT_NAME(DT_INST(0, zmk_behavior_key_press))
+
+// Keys are queued as bindings of this behavior with the keycode in param1 and this flag plus a
+// sequence number in param2, so that a press whose release did not fit into the queue can still
+// be skipped once the queue reaches it
+#define LANG_STRING_KEY BIT(31)
+
+static uint32_t next_key;
+// Key whose press is queued without its release, 0 for none
+static uint32_t cut_key;
+
+struct behavior_lang_string_config {
+    // Language switch (normally a no-layer-switch instance), invoked with the language in param1
+    const char *switch_behavior_dev;
+    // <LANG KEYCODE> pairs, LANG_ANY keys are typed on whatever language is active
+    const uint32_t *keys;
+    size_t keys_len;
+    uint32_t tap_ms;
+    uint32_t wait_ms;
+};
+
+static int behavior_lang_string_init(const struct device *dev) { return 0; };
+
+static void switch_language(const struct behavior_lang_string_config *config, uint8_t lang,
+                            bool pinned, struct zmk_behavior_binding_event *event) {
+    struct zmk_behavior_binding binding = {
+        .behavior_dev = config->switch_behavior_dev,
+        .param1 = lang,
+        .param2 = pinned ? ZMK_LANGUAGE_SWITCH_PINNED : 0,
+    };
+    // The switch sets the language state right away and queues its taps ahead of our keys
+    zmk_behavior_invoke_binding(&binding, *event, true);
+    zmk_behavior_invoke_binding(&binding, *event, false);
+}
+
+static int queue_key(const struct behavior_lang_string_config *config, const char *dev_name,
+                     uint32_t keycode, struct zmk_behavior_binding_event *event) {
+    const struct zmk_behavior_binding key = {
+        .behavior_dev = dev_name,
+        .param1 = keycode,
+        .param2 = LANG_STRING_KEY | next_key,
+    };
+    next_key = (next_key + 1) & ~LANG_STRING_KEY;
+    int ret = zmk_behavior_queue_add(event, key, true, config->tap_ms);
+    if (ret < 0) {
+        return ret;
+    }
+    ret = zmk_behavior_queue_add(event, key, false, config->wait_ms);
+    if (ret < 0) {
+        cut_key = key.param2;
+    }
+    return ret;
+}
+
+static void key_step(const struct zmk_behavior_binding *binding,
+                     struct zmk_behavior_binding_event event, bool pressed) {
+    if (binding->param2 == cut_key) {
+        LOG_DBG("LANG_STRING skipping key 0x%08X, its release was not queued", binding->param1);
+        return;
+    }
+    const struct zmk_behavior_binding key_binding = {
+        .behavior_dev = KEY_PRESS,
+        .param1 = binding->param1,
+    };
+    zmk_behavior_invoke_binding(&key_binding, event, pressed);
+}
+
+static int lang_string_binding_pressed(struct zmk_behavior_binding *binding,
+                                       struct zmk_behavior_binding_event event) {
+    if (binding->param2 & LANG_STRING_KEY) {
+        key_step(binding, event, true);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct behavior_lang_string_config *config = dev->config;
+    const uint8_t original_lang = zmk_language_state();
+
+    // Keys have to be typed in order, so the only freedom is for LANG_ANY keys: they stay on the
+    // current language, which makes every switch one that a later key actually requires
+    for (size_t i = 0; i + 1 < config->keys_len; i += 2) {
+        const uint32_t lang = config->keys[i];
+        if (lang != LANG_ANY && lang != zmk_language_state()) {
+            LOG_DBG("LANG_STRING switching to %d at key %zu", lang, i / 2);
+            switch_language(config, lang, true, &event);
+        }
+
+        if (queue_key(config, binding->behavior_dev, config->keys[i + 1], &event) < 0) {
+            // The rest of the string is dropped, the original language is still restored below
+            LOG_ERR("LANG_STRING behavior queue full, string cut short at key %zu", i / 2);
+            break;
+        }
+    }
+
+    if (zmk_language_state() != original_lang) {
+        LOG_DBG("LANG_STRING restoring language %d", original_lang);
+        switch_language(config, original_lang, false, &event);
+    }
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int lang_string_binding_released(struct zmk_behavior_binding *binding,
+                                        struct zmk_behavior_binding_event event) {
+    if (binding->param2 & LANG_STRING_KEY) {
+        key_step(binding, event, false);
+    }
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_lang_string_driver_api = {
+    .binding_pressed = lang_string_binding_pressed,
+    .binding_released = lang_string_binding_released};
+
+#define LANG_STRING_INST(n)                                                                        \
+    BUILD_ASSERT(DT_INST_PROP_LEN(n, keys) % 2 == 0,                                               \
+                 "keys must be a list of <LANG KEYCODE> pairs");                                   \
+    /* Two entries per key, a longer string does not even fit into an idle queue */              \
+    BUILD_ASSERT(DT_INST_PROP_LEN(n, keys) <= CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE,                     \
+                 "keys need more entries than CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE");                   \
+    static const uint32_t behavior_lang_string_keys_##n[] = DT_INST_PROP(n, keys);                 \
+    static const struct behavior_lang_string_config behavior_lang_string_config_##n = {            \
+        .switch_behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE(n, switch_behavior)),                \
+        .keys = behavior_lang_string_keys_##n,                                                     \
+        .keys_len = DT_INST_PROP_LEN(n, keys),                                                     \
+        .tap_ms = DT_INST_PROP(n, tap_ms),                                                         \
+        .wait_ms = DT_INST_PROP(n, wait_ms),                                                       \
+    };                                                                                             \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_lang_string_init, NULL, NULL,                              \
+                            &behavior_lang_string_config_##n, APPLICATION,                         \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_lang_string_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(LANG_STRING_INST)
+
+#endif
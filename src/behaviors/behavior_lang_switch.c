@@ -12,58 +12,263 @@
 
 #include <zmk/keymap.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
 #include <zmk/language.h>
+#include <zmk/language_trace.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/language_state_changed.h>
 
-uint8_t current_language_state = 0;
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+#include <zmk/events/hid_indicators_changed.h>
+#endif
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_DECLARE(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
 
 struct behavior_lang_config {
     struct zmk_behavior_binding behavior;
+    // Optional binding that cycles backwards through the languages
+    struct zmk_behavior_binding reverse_behavior;
+    bool has_reverse;
+    // Per-language direct-select bindings, NULL when cycling with `behavior`
+    const struct zmk_behavior_binding *direct_bindings;
+    // Hold time of each injected tap and pause after its release
+    uint32_t tap_ms;
+    uint32_t wait_ms;
+    // HID indicator (LED) bits the host uses to report the active language, 0 when unused
+    uint8_t indicator_mask;
     uint8_t n_languages;
     bool no_layer_switch;
+    struct zmk_language_stats *stats;
     uint8_t layers[];
 };
 
 struct behavior_lang_data {};
 
-static int behavior_lang_init(const struct device *dev) { return 0; };
+// Language the host is on according to the taps actually sent so far
+static uint8_t host_lang;
 
-static int get_number_of_switches(const struct behavior_lang_config *config, uint8_t target_lang) {
-    if (current_language_state == target_lang)
+#if IS_ENABLED(CONFIG_SETTINGS)
+static void lang_restore_layer_work_handler(struct k_work *work) {
+    zmk_keymap_layer_to(zmk_language_state());
+}
+
+static K_WORK_DEFINE(lang_restore_layer_work, lang_restore_layer_work_handler);
+#endif
+
+static int behavior_lang_init(const struct device *dev) {
+    const struct behavior_lang_config *config = dev->config;
+    zmk_language_stats_register(dev->name, config->stats);
+    // Resets out of range states of every endpoint, including those loaded below or later on
+    zmk_language_limit_count(config->n_languages);
+#if IS_ENABLED(CONFIG_SETTINGS)
+    zmk_language_load_state();
+
+    // Bring the language layer in line with the restored language once the system is up
+    if (zmk_language_state() != 0 && !config->no_layer_switch) {
+        k_work_submit(&lang_restore_layer_work);
+    }
+#endif
+    host_lang = zmk_language_state();
+    return 0;
+};
+
+static int get_number_of_switches(const struct behavior_lang_config *config, uint8_t current_lang,
+                                  uint8_t target_lang, bool *reverse) {
+    *reverse = false;
+    if (current_lang == target_lang)
         return 0;
-    if (current_language_state < target_lang) {
-        return target_lang - current_language_state;
+    if (config->direct_bindings != NULL) {
+        // Direct-select mode: one tap of the target's own hotkey regardless of cycle distance
+        return 1;
+    }
+    int forward;
+    if (current_lang < target_lang) {
+        forward = target_lang - current_lang;
     } else {
-        return config->n_languages - current_language_state + target_lang;
+        forward = config->n_languages - current_lang + target_lang;
     }
+    // Walk backwards when that takes strictly fewer taps
+    if (config->has_reverse && config->n_languages - forward < forward) {
+        *reverse = true;
+        return config->n_languages - forward;
+    }
+    return forward;
+};
+
+/*
+ * Switch taps are not queued as hotkey presses but as "steps" of this behavior that decide what
+ * to tap only when the queue reaches them. Every switch request belongs to a generation with a
+ * goal language; a step taps once towards its generation's goal, or does nothing if the host is
+ * already there. A request arriving while the newest generation still has steps waiting simply
+ * retargets it, so switches that cancel each other out never reach the host. Generations are
+ * pinned when a key queued right after them depends on their goal (kp-on-lang, lang-string);
+ * those are never retargeted and later requests start a new generation instead.
+ */
+#define LANG_STEP BIT(31)
+#define LANG_GENERATIONS MAX(CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE / 2, 1)
+
+struct lang_generation {
+    uint8_t goal;
+    bool pinned;
 };
 
+static struct lang_generation generations[LANG_GENERATIONS];
+static uint32_t newest_generation;
+// Language the newest generation starts from, whether its first step has run, and its steps not
+// yet executed
+static uint8_t newest_base;
+static bool newest_started;
+static uint8_t newest_steps_left;
+// Steps of every generation not yet executed
+static uint8_t queued_steps;
+// Hotkey pressed by the step currently in progress, released together with the step
+static const struct zmk_behavior_binding *step_tap;
+
+static void queue_switch_steps(const struct behavior_lang_config *config, const char *dev_name,
+                               struct zmk_behavior_binding_event *event, uint8_t count) {
+    const struct zmk_behavior_binding step = {
+        .behavior_dev = dev_name,
+        .param1 = LANG_STEP | newest_generation,
+    };
+    for (uint8_t i = 0; i < count; i++) {
+        // Counted before queueing, an idle queue runs the step right away
+        newest_steps_left++;
+        queued_steps++;
+        if (zmk_behavior_queue_add(event, step, true, config->tap_ms) < 0) {
+            queued_steps--;
+            LOG_ERR("LANG behavior queue full, dropping switch steps");
+            newest_steps_left = 0;
+            return;
+        }
+        if (zmk_behavior_queue_add(event, step, false, config->wait_ms) < 0) {
+            LOG_ERR("LANG behavior queue full, dropping switch steps");
+            newest_steps_left = 0;
+            return;
+        }
+    }
+}
+
+static void plan_switch(const struct behavior_lang_config *config, const char *dev_name,
+                        struct zmk_behavior_binding_event *event, uint8_t base,
+                        uint8_t target_lang, bool pinned) {
+    struct lang_generation *newest = &generations[newest_generation % LANG_GENERATIONS];
+    bool reverse;
+    if (newest_steps_left > 0 && !newest->pinned) {
+        // Nothing depends on the newest generation reaching its goal, aim its remaining steps at
+        // the new target. Once it has started, every earlier step has run and the host language
+        // is exactly where the remaining steps start from.
+        const uint8_t start = newest_started ? host_lang : newest_base;
+        const uint8_t needed = get_number_of_switches(config, start, target_lang, &reverse);
+        LOG_DBG("LANG retargeting pending switch from %d to %d", newest->goal, target_lang);
+        newest->goal = target_lang;
+        newest->pinned = pinned;
+        if (needed > newest_steps_left) {
+            queue_switch_steps(config, dev_name, event, needed - newest_steps_left);
+        }
+        return;
+    }
+
+    const uint8_t needed = get_number_of_switches(config, base, target_lang, &reverse);
+    newest_generation++;
+    newest = &generations[newest_generation % LANG_GENERATIONS];
+    newest->goal = target_lang;
+    newest->pinned = pinned;
+    newest_base = base;
+    newest_started = false;
+    newest_steps_left = 0;
+    queue_switch_steps(config, dev_name, event, needed);
+}
+
+static void step_pressed(const struct behavior_lang_config *config, uint32_t generation,
+                         struct zmk_behavior_binding_event event) {
+    if (queued_steps > 0) {
+        queued_steps--;
+    }
+    if (generation == newest_generation && newest_steps_left > 0) {
+        newest_started = true;
+        newest_steps_left--;
+    }
+    const uint8_t goal = generations[generation % LANG_GENERATIONS].goal;
+    bool reverse;
+    if (goal >= config->n_languages ||
+        get_number_of_switches(config, host_lang, goal, &reverse) == 0) {
+        LOG_DBG("LANG step skipped, host already on %d", host_lang);
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_TAP_SKIPPED, event.position);
+        step_tap = NULL;
+        return;
+    }
+
+    if (config->direct_bindings != NULL) {
+        step_tap = &config->direct_bindings[goal];
+        host_lang = goal;
+    } else if (reverse) {
+        step_tap = &config->reverse_behavior;
+        host_lang = (host_lang + config->n_languages - 1) % config->n_languages;
+    } else {
+        step_tap = &config->behavior;
+        host_lang = (host_lang + 1) % config->n_languages;
+    }
+    LOG_DBG("LANG switch, host now on %d", host_lang);
+    config->stats->injected_taps++;
+    zmk_language_trace(ZMK_LANGUAGE_TRACE_TAP, event.position);
+    zmk_behavior_invoke_binding(step_tap, event, true);
+}
+
+static void step_released(struct zmk_behavior_binding_event event) {
+    if (step_tap != NULL) {
+        zmk_behavior_invoke_binding(step_tap, event, false);
+        step_tap = NULL;
+    }
+}
+
+// Set while we change the language ourselves; the layer is then handled by the caller
+static bool lang_switch_in_progress = false;
+
+static void apply_language(const struct behavior_lang_config *config, uint8_t lang) {
+    lang_switch_in_progress = true;
+    zmk_language_set_state(lang);
+    lang_switch_in_progress = false;
+    if (!config->no_layer_switch) {
+        zmk_keymap_layer_to(lang);
+    }
+}
+
 static int lang_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                        struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
     const struct behavior_lang_config *config = dev->config;
 
-    const uint8_t number_of_switches = get_number_of_switches(config, binding->param1);
-    LOG_DBG("LANG current_lang %d target_lang %d number_of_switches %d", current_language_state,
-            binding->param1, number_of_switches);
-    // Switch needed number of times
-    if (number_of_switches > 0) {
-        for (uint8_t i = 0; i < number_of_switches; i++) {
-            zmk_behavior_queue_add(&event, config->behavior, true, 0);
-            zmk_behavior_queue_add(&event, config->behavior, false, 0);
-            LOG_DBG("LANG switch");
-        }
-        current_language_state = binding->param1;
-        if (!config->no_layer_switch) {
-            zmk_keymap_layer_to(binding->param1);
-        }
+    if (binding->param1 & LANG_STEP) {
+        step_pressed(config, binding->param1 & ~LANG_STEP, event);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    if (binding->param1 >= config->n_languages) {
+        LOG_ERR("LANG target_lang %d out of range (%d languages)", binding->param1,
+                config->n_languages);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    // The language state is the pending target: it is updated right away so that listeners
+    // reacting to the injected taps already see the target language
+    LOG_DBG("LANG current_lang %d target_lang %d host_lang %d", zmk_language_state(),
+            binding->param1, host_lang);
+    const uint8_t pending_lang = zmk_language_state();
+    if (pending_lang != binding->param1) {
+        config->stats->switches++;
+        apply_language(config, binding->param1);
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_SWITCH, event.position);
+        plan_switch(config, binding->behavior_dev, &event, pending_lang, binding->param1,
+                    binding->param2 & ZMK_LANGUAGE_SWITCH_PINNED);
     }
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
 static int lang_keymap_binding_released(struct zmk_behavior_binding *binding,
                                         struct zmk_behavior_binding_event event) {
+    if (binding->param1 & LANG_STEP) {
+        step_released(event);
+    }
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
@@ -71,16 +276,114 @@ static const struct behavior_driver_api behavior_lang_driver_api = {
     .binding_pressed = lang_keymap_binding_pressed,
     .binding_released = lang_keymap_binding_released};
 
+#define LANG_EXTRACT_BINDING(idx, drv_inst, prop)                                                  \
+    {                                                                                              \
+        .behavior_dev = DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(drv_inst, prop, idx)),                    \
+        .param1 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(drv_inst, prop, idx, param1), (0),            \
+                              (DT_PHA_BY_IDX(drv_inst, prop, idx, param1))),                       \
+        .param2 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(drv_inst, prop, idx, param2), (0),            \
+                              (DT_PHA_BY_IDX(drv_inst, prop, idx, param2))),                       \
+    }
+
+#define LANG_DIRECT_BINDINGS(n)                                                                    \
+    COND_CODE_1(                                                                                   \
+        DT_INST_NODE_HAS_PROP(n, direct_bindings),                                                 \
+        (BUILD_ASSERT(DT_INST_PROP_LEN(n, direct_bindings) == DT_INST_PROP_LEN(n, layers),         \
+                      "direct-bindings must have one binding per language");                       \
+         static const struct zmk_behavior_binding behavior_lang_direct_bindings_##n[] = {          \
+             LISTIFY(DT_INST_PROP_LEN(n, direct_bindings), LANG_EXTRACT_BINDING, (, ),             \
+                     DT_DRV_INST(n), direct_bindings)};),                                          \
+        ())
+
 #define LANG_INST(n)                                                                               \
+    LANG_DIRECT_BINDINGS(n)                                                                        \
     static struct behavior_lang_data behavior_lang_data_##n = {};                                  \
+    static struct zmk_language_stats behavior_lang_stats_##n = {};                                 \
     static struct behavior_lang_config behavior_lang_config_##n = {                                \
         .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, DT_DRV_INST(n)),                                 \
+        .reverse_behavior =                                                                        \
+            COND_CODE_1(DT_INST_NODE_HAS_PROP(n, reverse_bindings),                                \
+                        (LANG_EXTRACT_BINDING(0, DT_DRV_INST(n), reverse_bindings)), ({})),        \
+        .has_reverse = DT_INST_NODE_HAS_PROP(n, reverse_bindings),                                 \
+        .direct_bindings = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, direct_bindings),                  \
+                                       (behavior_lang_direct_bindings_##n), (NULL)),               \
         .layers = DT_INST_PROP(n, layers),                                                         \
         .n_languages = DT_INST_PROP_LEN(n, layers),                                                \
+        .tap_ms = DT_INST_PROP(n, tap_ms),                                                         \
+        .wait_ms = DT_INST_PROP(n, wait_ms),                                                       \
         .no_layer_switch = DT_INST_PROP(n, no_layer_switch),                                       \
+        .indicator_mask = DT_INST_PROP(n, indicator_mask),                                         \
+        .stats = &behavior_lang_stats_##n,                                                         \
     };                                                                                             \
     BEHAVIOR_DT_INST_DEFINE(n, behavior_lang_init, NULL, &behavior_lang_data_##n,                  \
                             &behavior_lang_config_##n, APPLICATION,                                \
                             CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_lang_driver_api);
 
 DT_INST_FOREACH_STATUS_OKAY(LANG_INST)
+
+#define LANG_CONFIG_REF(n) &behavior_lang_config_##n,
+#define LANG_LAYER_SWITCH_INST(n) || !DT_INST_PROP(n, no_layer_switch)
+#define LANG_INDICATOR_INST(n) +(DT_INST_PROP(n, indicator_mask) != 0)
+
+// The host reports a single language, so a single instance may decode it
+BUILD_ASSERT((0 DT_INST_FOREACH_STATUS_OKAY(LANG_INDICATOR_INST)) <= 1,
+             "indicator-mask may only be set on one lang-switch instance");
+
+static const struct behavior_lang_config *const lang_configs[] = {
+    DT_INST_FOREACH_STATUS_OKAY(LANG_CONFIG_REF)};
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+// Resync the language from indicator bits driven by the host, without injecting any taps
+static int lang_hid_indicators_changed(const struct zmk_hid_indicators_changed *ev) {
+    if (queued_steps > 0) {
+        // Reports arriving while our taps are still being sent show a language the host is only
+        // passing through, or the one it left
+        LOG_DBG("LANG ignoring host indicators 0x%02X, switch taps still queued", ev->indicators);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    for (int i = 0; i < ARRAY_SIZE(lang_configs); i++) {
+        const struct behavior_lang_config *config = lang_configs[i];
+        if (config->indicator_mask == 0) {
+            continue;
+        }
+        const uint8_t lang =
+            (ev->indicators & config->indicator_mask) >> __builtin_ctz(config->indicator_mask);
+        if (lang < config->n_languages && lang != zmk_language_state()) {
+            LOG_DBG("LANG host reports language %d (was %d)", lang, zmk_language_state());
+            zmk_language_set_state(lang);
+        }
+        break;
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+#endif
+
+static int lang_switch_listener(const zmk_event_t *eh) {
+    const struct zmk_language_state_changed *lang_ev = as_zmk_language_state_changed(eh);
+    if (lang_ev != NULL) {
+        if (!lang_switch_in_progress) {
+            // Changes made elsewhere (host resync, endpoint switch) describe the host directly
+            host_lang = lang_ev->state;
+        }
+        // Follow changes made elsewhere with the language layer
+        if ((0 DT_INST_FOREACH_STATUS_OKAY(LANG_LAYER_SWITCH_INST)) && !lang_switch_in_progress) {
+            LOG_DBG("LANG following language %d with layer", lang_ev->state);
+            zmk_keymap_layer_to(lang_ev->state);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    const struct zmk_hid_indicators_changed *hid_ev = as_zmk_hid_indicators_changed(eh);
+    if (hid_ev != NULL) {
+        return lang_hid_indicators_changed(hid_ev);
+    }
+#endif
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LANGUAGE_LISTENER(behavior_lang_switch, lang_switch_listener);
+ZMK_SUBSCRIPTION(behavior_lang_switch, zmk_language_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+ZMK_SUBSCRIPTION(behavior_lang_switch, zmk_hid_indicators_changed);
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_lang_sync
+
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/behavior.h>
+#include <zmk/language.h>
+
+LOG_MODULE_DECLARE(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+/*
+ * Carries the language state from the central to split peripherals. The central invokes this
+ * global-locality behavior with the new language in param1 whenever it changes (and when a
+ * peripheral connects), so a single press message is all that crosses the split link. ZMK's split
+ * transport has no message type a module could add, so the generic run-behavior command is used
+ * rather than a dedicated one-byte update.
+ */
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+#if __has_include(<zmk/split/transport/types.h>)
+#include <zmk/split/transport/types.h>
+#elif __has_include(<zmk/split/bluetooth/service.h>)
+#include <zmk/split/bluetooth/service.h>
+#endif
+
+#ifdef ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN
+// Peripherals look the behavior up by the name sent with the command, which is cut to this size
+BUILD_ASSERT(sizeof(DEVICE_DT_NAME(DT_DRV_INST(0))) <= ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN,
+             "lang-sync node name is too long to be sent to split peripherals");
+#endif
+#endif
+
+static int behavior_lang_sync_init(const struct device *dev) { return 0; };
+
+static int lang_sync_binding_pressed(struct zmk_behavior_binding *binding,
+                                     struct zmk_behavior_binding_event event) {
+    zmk_language_set_state(binding->param1);
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int lang_sync_binding_released(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_lang_sync_driver_api = {
+    .locality = BEHAVIOR_LOCALITY_GLOBAL,
+    .binding_pressed = lang_sync_binding_pressed,
+    .binding_released = lang_sync_binding_released};
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/event_manager.h>
+#include <zmk/events/language_state_changed.h>
+#include <zmk/events/split_peripheral_status_changed.h>
+#include <zmk/language_trace.h>
+
+static void lang_sync_send(uint8_t state) {
+    struct zmk_behavior_binding binding = {
+        .behavior_dev = DEVICE_DT_NAME(DT_DRV_INST(0)),
+        .param1 = state,
+    };
+    struct zmk_behavior_binding_event event = {
+        .position = 0,
+        .timestamp = k_uptime_get(),
+    };
+    LOG_DBG("LANG_SYNC sending language %d to peripherals", state);
+    zmk_behavior_invoke_binding(&binding, event, true);
+}
+
+static int lang_sync_listener(const zmk_event_t *eh) {
+    const struct zmk_language_state_changed *lang_ev = as_zmk_language_state_changed(eh);
+    if (lang_ev != NULL) {
+        lang_sync_send(lang_ev->state);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_split_peripheral_status_changed *split_ev =
+        as_zmk_split_peripheral_status_changed(eh);
+    if (split_ev != NULL && split_ev->connected) {
+        // Peripherals only hear about changes, bring a newly connected one up to date
+        lang_sync_send(zmk_language_state());
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LANGUAGE_LISTENER(behavior_lang_sync, lang_sync_listener);
+ZMK_SUBSCRIPTION(behavior_lang_sync, zmk_language_state_changed);
+ZMK_SUBSCRIPTION(behavior_lang_sync, zmk_split_peripheral_status_changed);
+#endif
+
+BEHAVIOR_DT_INST_DEFINE(0, behavior_lang_sync_init, NULL, NULL, NULL, APPLICATION,
+                        CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_lang_sync_driver_api);
+
+#endif /* DT_HAS_COMPAT_STATUS_OKAY */
@@ -12,7 +12,6 @@
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
-#include <string.h>
 
 #include <zmk/matrix.h>
 #include <zmk/endpoints.h>
@@ -20,57 +19,164 @@
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
+#include <zmk/events/layer_state_changed.h>
 #include <zmk/hid.h>
 #include <zmk/keymap.h>
+#include <zmk/language.h>
+#include <zmk/language_trace.h>
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_DECLARE(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
-#define KEY_PRESS DEVICE_DT_NAME(DT_INST(0, zmk_behavior_key_press))
-
 #define ZMK_BHV_STICKY_KEY_MAX_HELD CONFIG_ZMK_BEHAVIOR_STICKY_KEY_MAX_HELD
 #define ZMK_BHV_STICKY_KEY_POSITION_FREE UINT32_MAX
+#define SKL_KEY_PRESS_NODE DT_INST(0, zmk_behavior_key_press)
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+/*
+ * Switchable-position table
+ * -------------------------
+ * For every instance a (layer, position) bitmap is built from the keymap at compile time. A bit
+ * is set when the binding at that position is one of the instance's `switch-behaviors` (or `&kp`
+ * when the property is omitted), so the position listener decides with a single bit test.
+ */
+#define SKL_KEYMAP_NODE DT_INST(0, zmk_keymap)
+#define SKL_POSITION_WORDS DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+BUILD_ASSERT(ZMK_KEYMAP_LEN <= 256, "SKL: switchable-position table supports up to 256 positions");
+
+#define SKL_BEHAVIOR_MATCH(node_id, prop, idx, behavior)                                           \
+    || (DT_DEP_ORD(DT_PHANDLE_BY_IDX(node_id, prop, idx)) == DT_DEP_ORD(behavior))
+
+#define SKL_BEHAVIOR_SWITCHABLE(n, behavior)                                                       \
+    COND_CODE_1(DT_INST_NODE_HAS_PROP(n, switch_behaviors),                                        \
+                ((0 DT_INST_FOREACH_PROP_ELEM_VARGS(n, switch_behaviors, SKL_BEHAVIOR_MATCH,       \
+                                                    behavior))),                                   \
+                ((DT_DEP_ORD(behavior) == DT_DEP_ORD(SKL_KEY_PRESS_NODE))))
+
+#define SKL_POSITION_BIT(idx, layer, n, word)                                                      \
+    | ((((idx) / 32) == (word) &&                                                                  \
+        SKL_BEHAVIOR_SWITCHABLE(n, DT_PHANDLE_BY_IDX(layer, bindings, idx)))                       \
+           ? BIT((idx) % 32)                                                                       \
+           : 0)
+
+#define SKL_POSITION_WORD(layer, n, word)                                                          \
+    (0 LISTIFY(DT_PROP_LEN(layer, bindings), SKL_POSITION_BIT, (), layer, n, word))
+
+#define SKL_LAYER_ROW(layer, n)                                                                    \
+    {                                                                                              \
+        SKL_POSITION_WORD(layer, n, 0),                                                            \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 32), (SKL_POSITION_WORD(layer, n, 1), ))       \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 64), (SKL_POSITION_WORD(layer, n, 2), ))       \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 96), (SKL_POSITION_WORD(layer, n, 3), ))       \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 128), (SKL_POSITION_WORD(layer, n, 4), ))      \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 160), (SKL_POSITION_WORD(layer, n, 5), ))      \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 192), (SKL_POSITION_WORD(layer, n, 6), ))      \
+        IF_ENABLED(DT_PROP_HAS_IDX(layer, bindings, 224), (SKL_POSITION_WORD(layer, n, 7), ))      \
+    },
+
+#define SKL_LAYER_BIT(node_id, prop, idx) | BIT(DT_PROP_BY_IDX(node_id, prop, idx))
+
+#define SKL_INTERCEPTION_CONFIG(n)                                                                 \
+    .virtual_layer = DT_INST_PROP(n, virtual_layer),                                               \
+    .switch_layers = (0 DT_INST_FOREACH_PROP_ELEM(n, switch_layers, SKL_LAYER_BIT)),               \
+    .switchable = behavior_sticky_key_layer_switchable_##n,
+
+#define SKL_INTERCEPTION_TABLE(n)                                                                  \
+    static const uint32_t behavior_sticky_key_layer_switchable_##n[ZMK_KEYMAP_LAYERS_LEN]          \
+                                                                  [SKL_POSITION_WORDS] = {         \
+        DT_FOREACH_CHILD_VARGS(SKL_KEYMAP_NODE, SKL_LAYER_ROW, n)};
+#else
+#define SKL_INTERCEPTION_CONFIG(n)
+#define SKL_INTERCEPTION_TABLE(n)
+#endif
 
 struct behavior_sticky_key_config {
     uint32_t release_after_ms;
     bool quick_release;
     bool lazy;
     bool ignore_modifiers;
+    // Bound behavior is `&kp`, resolved at build time so self-generated keycode events can be
+    // recognized without comparing device names
+    bool is_key_press;
     zmk_keymap_layer_id_t target_layer;
     struct zmk_behavior_binding behavior;
+    struct zmk_language_stats *stats;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+    // Resolve intercepted positions on the target layer without touching the global layer state
+    bool virtual_layer;
+    // Layers whose positions may be intercepted (`switch-layers`)
+    zmk_keymap_layers_state_t switch_layers;
+    const uint32_t (*switchable)[SKL_POSITION_WORDS];
+#endif
 };
 
 struct active_sticky_key {
+    int64_t release_at;
+    const struct behavior_sticky_key_config *config;
+    // Original layer state, saved when a position is intercepted and restored afterwards
+    zmk_keymap_layers_state_t saved_layer_state;
     uint32_t position;
+    uint32_t param1;
+    uint32_t modified_key_keycode;
+    uint8_t modified_key_usage_page;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
     uint8_t source;
 #endif
-    uint32_t param1;
-    uint32_t param2;
-    const struct behavior_sticky_key_config *config;
-    bool timer_started;
-    bool timer_cancelled;
-    int64_t release_at;
-    struct k_work_delayable release_timer;
-    uint8_t modified_key_usage_page;
-    uint32_t modified_key_keycode;
-    // NEW: target layer for switching
-    zmk_keymap_layer_id_t target_layer;
-    bool layer_was_active; // track if layer was already active before we activated it
-    // NEW: save original layer state for restoration
-    zmk_keymap_layers_state_t saved_layer_state;
+    bool timer_started : 1;
+    // Target layer was already active before the sticky key activated it
+    bool layer_was_active : 1;
 };
 
 static struct active_sticky_key active_sticky_keys[ZMK_BHV_STICKY_KEY_MAX_HELD] = {};
 
+// Strictly below 32: BIT_MASK(32) shifts a 32-bit long out of range on nRF52 and other targets
+BUILD_ASSERT(ZMK_BHV_STICKY_KEY_MAX_HELD < 32, "Sticky key slots must fit in a 32-bit mask");
+
+// One bit per occupied slot of active_sticky_keys / virtual_layer_presses, so the listeners can
+// skip the slot scan entirely while no sticky key is in use
+static uint32_t active_sticky_mask;
+
+// Slots waiting for their release_at deadline. All of them share one delayable work item that is
+// always scheduled for the earliest deadline, so a burst of sticky keys costs a single wakeup.
+static uint32_t release_pending_mask;
+static struct k_work_delayable release_timer;
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+// Positions pressed through a virtual-layer lookup, released with the same binding
+struct virtual_layer_press {
+    uint32_t position;
+    zmk_keymap_layer_id_t layer;
+    struct zmk_behavior_binding binding;
+};
+
+static struct virtual_layer_press virtual_layer_presses[ZMK_BHV_STICKY_KEY_MAX_HELD] = {};
+static uint32_t virtual_press_mask;
+
+// Topmost active layer, kept up to date by the layer state listener so that the position
+// listener does not have to scan the layer stack on every key press
+static zmk_keymap_layer_id_t highest_active_layer = ZMK_KEYMAP_LAYER_ID_INVAL;
+
+static void update_highest_active_layer(void) {
+    highest_active_layer = ZMK_KEYMAP_LAYER_ID_INVAL;
+    // Iterate from highest to lowest layer (same logic as ZMK's keymap resolution)
+    for (zmk_keymap_layer_id_t layer_id = ZMK_KEYMAP_LAYERS_LEN - 1;
+         layer_id >= zmk_keymap_layer_default(); layer_id--) {
+        if (zmk_keymap_layer_active(layer_id)) {
+            highest_active_layer = layer_id;
+            break;
+        }
+    }
+}
+#endif
+
 static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_event *event,
                                                   uint32_t param1,
                                                   const struct behavior_sticky_key_config *config) {
     for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
         struct active_sticky_key *const sticky_key = &active_sticky_keys[i];
-        if (sticky_key->position != ZMK_BHV_STICKY_KEY_POSITION_FREE ||
-            sticky_key->timer_cancelled) {
+        if (sticky_key->position != ZMK_BHV_STICKY_KEY_POSITION_FREE) {
             continue;
         }
         sticky_key->position = event->position;
@@ -78,20 +184,17 @@ static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_ev
         sticky_key->source = event->source;
 #endif
         sticky_key->param1 = param1;
-        sticky_key->param2 = 0; // Not used anymore
         sticky_key->config = config;
         sticky_key->release_at = 0;
-        sticky_key->timer_cancelled = false;
         sticky_key->timer_started = false;
         sticky_key->modified_key_usage_page = 0;
         sticky_key->modified_key_keycode = 0;
-        // NEW: store target layer from config
-        sticky_key->target_layer = config->target_layer;
-        sticky_key->layer_was_active = zmk_keymap_layer_active(sticky_key->target_layer);
+        sticky_key->layer_was_active = zmk_keymap_layer_active(config->target_layer);
         sticky_key->saved_layer_state = 0; // Will be set when needed
+        active_sticky_mask |= BIT(i);
 
         LOG_DBG("SKL: stored sticky key pos=%d, mod=%d, target_layer=%d, layer_was_active=%d",
-                event->position, param1, sticky_key->target_layer, sticky_key->layer_was_active);
+                event->position, param1, config->target_layer, sticky_key->layer_was_active);
         return sticky_key;
     }
     return NULL;
@@ -100,32 +203,66 @@ static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_ev
 static void clear_sticky_key(struct active_sticky_key *sticky_key) {
     LOG_DBG("SKL: clearing sticky key pos=%d", sticky_key->position);
     sticky_key->position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+    sticky_key->saved_layer_state = 0;
+    active_sticky_mask &= ~BIT(sticky_key - active_sticky_keys);
+    release_pending_mask &= ~BIT(sticky_key - active_sticky_keys);
 }
 
 static struct active_sticky_key *find_sticky_key(uint32_t position) {
     for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-        if (active_sticky_keys[i].position == position && !active_sticky_keys[i].timer_cancelled) {
+        if (active_sticky_keys[i].position == position) {
             return &active_sticky_keys[i];
         }
     }
     return NULL;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+static inline bool position_is_switchable(const struct behavior_sticky_key_config *config,
+                                          zmk_keymap_layer_id_t layer, uint32_t position) {
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN || position >= ZMK_KEYMAP_LEN ||
+        (config->switch_layers & BIT(layer)) == 0) {
+        return false;
+    }
+    return (config->switchable[layer][position / 32] & BIT(position % 32)) != 0;
+}
+#endif
+
+// ZMK has no bulk layer setter, so apply only the difference to the current layer state: one
+// layer-state-changed event per layer that actually changes, and none for untouched layers.
+static void apply_layer_state(zmk_keymap_layers_state_t target) {
+    const zmk_keymap_layers_state_t current = zmk_keymap_layer_state();
+    zmk_keymap_layers_state_t to_activate = target & ~current;
+    zmk_keymap_layers_state_t to_deactivate = current & ~target & ~BIT(zmk_keymap_layer_default());
+
+    // Activate first so the stack never passes through a state with fewer layers than both ends
+    while (to_activate != 0) {
+        zmk_keymap_layer_activate(__builtin_ctz(to_activate));
+        to_activate &= to_activate - 1;
+    }
+    while (to_deactivate != 0) {
+        zmk_keymap_layer_deactivate(__builtin_ctz(to_deactivate));
+        to_deactivate &= to_deactivate - 1;
+    }
+}
+
 static inline int activate_target_layer(struct active_sticky_key *sticky_key) {
-    if (!zmk_keymap_layer_active(sticky_key->target_layer)) {
-        LOG_DBG("SKL: activating target layer %d", sticky_key->target_layer);
-        return zmk_keymap_layer_activate(sticky_key->target_layer);
+    const zmk_keymap_layer_id_t target_layer = sticky_key->config->target_layer;
+    if (!zmk_keymap_layer_active(target_layer)) {
+        LOG_DBG("SKL: activating target layer %d", target_layer);
+        return zmk_keymap_layer_activate(target_layer);
     }
-    LOG_DBG("SKL: target layer %d already active", sticky_key->target_layer);
+    LOG_DBG("SKL: target layer %d already active", target_layer);
     return 0;
 }
 
 static inline int deactivate_target_layer(struct active_sticky_key *sticky_key) {
-    if (!sticky_key->layer_was_active && zmk_keymap_layer_active(sticky_key->target_layer)) {
-        LOG_DBG("SKL: deactivating target layer %d", sticky_key->target_layer);
-        return zmk_keymap_layer_deactivate(sticky_key->target_layer);
+    const zmk_keymap_layer_id_t target_layer = sticky_key->config->target_layer;
+    if (!sticky_key->layer_was_active && zmk_keymap_layer_active(target_layer)) {
+        LOG_DBG("SKL: deactivating target layer %d", target_layer);
+        return zmk_keymap_layer_deactivate(target_layer);
     }
-    LOG_DBG("SKL: not deactivating layer %d (was_active_before=%d)", sticky_key->target_layer,
+    LOG_DBG("SKL: not deactivating layer %d (was_active_before=%d)", target_layer,
             sticky_key->layer_was_active);
     return 0;
 }
@@ -187,12 +324,55 @@ static inline void on_sticky_key_timeout(struct active_sticky_key *sticky_key) {
     }
 }
 
-static int stop_timer(struct active_sticky_key *sticky_key) {
-    int timer_cancel_result = k_work_cancel_delayable(&sticky_key->release_timer);
-    if (timer_cancel_result == -EINPROGRESS) {
-        sticky_key->timer_cancelled = true;
+#if IS_ENABLED(CONFIG_ASSERT)
+// Slot bookkeeping invariants, checked after every listener and timer run so that an
+// inconsistent sequence of presses, releases and timeouts fails at the step that caused it
+static void check_sticky_invariants(void) {
+    for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
+        const bool occupied = active_sticky_keys[i].position != ZMK_BHV_STICKY_KEY_POSITION_FREE;
+        __ASSERT(occupied == ((active_sticky_mask & BIT(i)) != 0),
+                 "sticky key slot %d does not match the active mask", i);
+        __ASSERT(occupied || active_sticky_keys[i].saved_layer_state == 0,
+                 "free sticky key slot %d still holds a saved layer state", i);
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+        const bool pressed =
+            virtual_layer_presses[i].position != ZMK_BHV_STICKY_KEY_POSITION_FREE;
+        __ASSERT(pressed == ((virtual_press_mask & BIT(i)) != 0),
+                 "virtual layer press slot %d does not match the press mask", i);
+#endif
+    }
+    __ASSERT((release_pending_mask & ~active_sticky_mask) == 0,
+             "release timer pending for a free sticky key slot");
+}
+#else
+static inline void check_sticky_invariants(void) {}
+#endif
+
+static void schedule_release_timer(void) {
+    if (release_pending_mask == 0) {
+        k_work_cancel_delayable(&release_timer);
+        return;
+    }
+
+    int64_t earliest = INT64_MAX;
+    for (uint32_t slots = release_pending_mask; slots != 0; slots &= slots - 1) {
+        earliest = MIN(earliest, active_sticky_keys[__builtin_ctz(slots)].release_at);
+    }
+    const int64_t ms_left = earliest - k_uptime_get();
+    k_work_reschedule(&release_timer, K_MSEC(MAX(ms_left, 0)));
+}
+
+static void start_timer(struct active_sticky_key *sticky_key) {
+    release_pending_mask |= BIT(sticky_key - active_sticky_keys);
+    schedule_release_timer();
+}
+
+static void stop_timer(struct active_sticky_key *sticky_key) {
+    const uint32_t slot = BIT(sticky_key - active_sticky_keys);
+    if (release_pending_mask & slot) {
+        release_pending_mask &= ~slot;
+        schedule_release_timer();
     }
-    return timer_cancel_result;
 }
 
 static int on_sticky_key_binding_pressed(struct zmk_behavior_binding *binding,
@@ -221,7 +401,7 @@ static int on_sticky_key_binding_pressed(struct zmk_behavior_binding *binding,
     }
 
     LOG_DBG("SKL: new sticky_key at pos %d, lazy=%d, target_layer=%d", event.position,
-            sticky_key->config->lazy, sticky_key->target_layer);
+            sticky_key->config->lazy, sticky_key->config->target_layer);
 
     if (!sticky_key->config->lazy) {
         // Press the key now if it's not lazy
@@ -254,7 +434,7 @@ static int on_sticky_key_binding_released(struct zmk_behavior_binding *binding,
     sticky_key->release_at = event.timestamp + sticky_key->config->release_after_ms;
     int32_t ms_left = sticky_key->release_at - k_uptime_get();
     if (ms_left > 0) {
-        k_work_schedule(&sticky_key->release_timer, K_MSEC(ms_left));
+        start_timer(sticky_key);
     }
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -291,12 +471,12 @@ static const struct behavior_driver_api behavior_sticky_key_layer_driver_api = {
 
 static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh);
 
-ZMK_LISTENER(behavior_sticky_key_layer, sticky_key_keycode_state_changed_listener);
+ZMK_LANGUAGE_LISTENER(behavior_sticky_key_layer, sticky_key_keycode_state_changed_listener);
 ZMK_SUBSCRIPTION(behavior_sticky_key_layer, zmk_keycode_state_changed);
 
 static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev == NULL) {
+    if (ev == NULL || active_sticky_mask == 0) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
@@ -319,9 +499,9 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
         }
 
         LOG_DBG("SKL: checking sticky key pos=%d, mod=%d, layer=%d", sticky_key->position,
-                sticky_key->param1, sticky_key->target_layer);
+                sticky_key->param1, sticky_key->config->target_layer);
 
-        if (strcmp(sticky_key->config->behavior.behavior_dev, KEY_PRESS) == 0 &&
+        if (sticky_key->config->is_key_press &&
             ZMK_HID_USAGE_ID(sticky_key->param1) == ev_copy.keycode &&
             ZMK_HID_USAGE_PAGE(sticky_key->param1) == ev_copy.usage_page &&
             SELECT_MODS(sticky_key->param1) == ev_copy.implicit_modifiers) {
@@ -401,9 +581,11 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
 
     // Restore layer state after processing if we changed it (only on key press)
     // But DON'T restore if a layer-switching behavior (like a combo) has changed layers
-    if (target_layer_key && ev_copy.state && saved_layer_state_to_restore != 0) {
+    if (IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION) && target_layer_key &&
+        ev_copy.state && saved_layer_state_to_restore != 0) {
         zmk_keymap_layers_state_t current_layer_state = zmk_keymap_layer_state();
-        zmk_keymap_layers_state_t expected_layer_state = BIT(target_layer_key->target_layer);
+        zmk_keymap_layers_state_t expected_layer_state =
+            BIT(target_layer_key->config->target_layer);
         
         // Only restore if we're still on the target layer (no combo switched us away)
         // If current state matches what we set (target layer), then restore
@@ -413,18 +595,9 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
         if (!layer_was_changed_by_other_behavior) {
             LOG_DBG("SKL: restoring layer state after key processing (0x%llx -> 0x%llx)", 
                     current_layer_state, saved_layer_state_to_restore);
-            // Restore all layers
-            for (zmk_keymap_layer_id_t layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
-                bool should_be_active = (saved_layer_state_to_restore & BIT(layer)) != 0;
-                bool currently_active = zmk_keymap_layer_active(layer);
-
-                if (should_be_active && !currently_active) {
-                    zmk_keymap_layer_activate(layer);
-                } else if (!should_be_active && currently_active &&
-                           layer != zmk_keymap_layer_default()) {
-                    zmk_keymap_layer_deactivate(layer);
-                }
-            }
+            target_layer_key->config->stats->sticky_layer_restores++;
+            zmk_language_trace(ZMK_LANGUAGE_TRACE_STICKY_RESTORE, target_layer_key->position);
+            apply_layer_state(saved_layer_state_to_restore);
         } else {
             LOG_DBG("SKL: NOT restoring layer state - another behavior changed it (saved: 0x%llx, expected: 0x%llx, current: 0x%llx)",
                     saved_layer_state_to_restore, expected_layer_state, current_layer_state);
@@ -433,30 +606,77 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
         target_layer_key->saved_layer_state = 0;
     }
 
+    check_sticky_invariants();
     return event_reraised ? ZMK_EV_EVENT_CAPTURED : ZMK_EV_EVENT_BUBBLE;
 }
 
-static int sticky_key_position_state_changed_listener(const zmk_event_t *eh) {
-    struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
-    if (ev == NULL) {
-        return ZMK_EV_EVENT_BUBBLE;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+static bool press_virtual_layer_binding(const struct zmk_position_state_changed *ev,
+                                        zmk_keymap_layer_id_t layer) {
+    const struct zmk_behavior_binding *binding =
+        zmk_keymap_get_layer_binding_at_idx(layer, ev->position);
+    if (binding == NULL || binding->behavior_dev == NULL) {
+        return false;
     }
 
-    // Handle key releases - DON'T restore layer state here
-    // Layer restoration should happen in keycode listener or when sticky key is released
-    if (!ev->state) {
-        return ZMK_EV_EVENT_BUBBLE;
+    const uint32_t free_slots = ~virtual_press_mask & BIT_MASK(ZMK_BHV_STICKY_KEY_MAX_HELD);
+    if (free_slots == 0) {
+        LOG_ERR("SKL: no free slot for virtual layer press at position %d", ev->position);
+        return false;
     }
 
-    // Check if we have any active sticky keys that need layer switching
-    struct active_sticky_key *target_layer_key = NULL;
-    bool found_any_sticky_key = false;
+    struct zmk_behavior_binding_event event = {
+        .layer = layer,
+        .position = ev->position,
+        .timestamp = ev->timestamp,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+        .source = ev->source,
+#endif
+    };
+    if (zmk_behavior_invoke_binding(binding, event, true) == ZMK_BEHAVIOR_TRANSPARENT) {
+        // Transparent on the target layer, let the keymap resolve it as usual
+        return false;
+    }
+    LOG_DBG("SKL: position %d resolved on layer %d without switching layers", ev->position,
+            layer);
+    const int slot = __builtin_ctz(free_slots);
+    virtual_layer_presses[slot].position = ev->position;
+    virtual_layer_presses[slot].layer = layer;
+    virtual_layer_presses[slot].binding = *binding;
+    virtual_press_mask |= BIT(slot);
+    return true;
+}
 
-    for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-        struct active_sticky_key *sticky_key = &active_sticky_keys[i];
-        if (sticky_key->position == ZMK_BHV_STICKY_KEY_POSITION_FREE) {
+static int release_virtual_layer_press(const struct zmk_position_state_changed *ev) {
+    for (uint32_t slots = virtual_press_mask; slots != 0; slots &= slots - 1) {
+        const int i = __builtin_ctz(slots);
+        struct virtual_layer_press *press = &virtual_layer_presses[i];
+        if (press->position != ev->position) {
             continue;
         }
+        struct zmk_behavior_binding_event event = {
+            .layer = press->layer,
+            .position = ev->position,
+            .timestamp = ev->timestamp,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+            .source = ev->source,
+#endif
+        };
+        press->position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+        virtual_press_mask &= ~BIT(i);
+        zmk_behavior_invoke_binding(&press->binding, event, false);
+        return ZMK_EV_EVENT_HANDLED;
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+// Sticky key whose target layer should resolve a pressed position, NULL if there is none
+static struct active_sticky_key *
+find_intercepting_sticky_key(const struct zmk_position_state_changed *ev) {
+    struct active_sticky_key *target_layer_key = NULL;
+
+    for (uint32_t slots = active_sticky_mask; slots != 0; slots &= slots - 1) {
+        struct active_sticky_key *sticky_key = &active_sticky_keys[__builtin_ctz(slots)];
 
         // Skip if sticky key already has a modified key (unless it's the same position - multi-tap
         // case)
@@ -464,9 +684,11 @@ static int sticky_key_position_state_changed_listener(const zmk_event_t *eh) {
             sticky_key->position != ev->position) {
             continue;
         }
-
-        // We found a sticky key that should handle layer switching
-        found_any_sticky_key = true;
+        // Expired but its timer has not run yet: the keycode listener times it out instead of
+        // restoring the layer state saved here
+        if (sticky_key->release_at != 0 && ev->timestamp > sticky_key->release_at) {
+            continue;
+        }
 
         // For multiple sticky keys, use the first one with a target layer, but prefer any that
         // don't already have a modified key
@@ -475,122 +697,141 @@ static int sticky_key_position_state_changed_listener(const zmk_event_t *eh) {
             target_layer_key = sticky_key;
         }
     }
+    if (target_layer_key == NULL) {
+        return NULL;
+    }
 
-    // If we have a target layer key, check if we should switch layers for this position
-    if (target_layer_key && found_any_sticky_key) {
-        // Find the highest active layer for this position (same logic as ZMK's keymap resolution)
-        zmk_keymap_layer_id_t current_layer = ZMK_KEYMAP_LAYER_ID_INVAL;
-
-        // Iterate from highest to lowest layer to find which layer would handle this position
-        for (zmk_keymap_layer_id_t layer_id = ZMK_KEYMAP_LAYERS_LEN - 1;
-             layer_id >= zmk_keymap_layer_default(); layer_id--) {
+    const zmk_keymap_layer_id_t current_layer = highest_active_layer;
+    if (current_layer == ZMK_KEYMAP_LAYER_ID_INVAL) {
+        LOG_DBG("SKL: no active layer found for position %d", ev->position);
+        return NULL;
+    }
+    if (!position_is_switchable(target_layer_key->config, current_layer, ev->position)) {
+        LOG_DBG("SKL: skipping layer switch for position %d (layer %d)", ev->position,
+                current_layer);
+        return NULL;
+    }
+    return target_layer_key;
+}
 
-            if (zmk_keymap_layer_active(layer_id)) {
-                current_layer = layer_id;
-                break;
-            }
-        }
+static int sticky_key_position_state_changed_listener(const zmk_event_t *eh) {
+    struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    // Handle key presses only - DON'T restore layer state on release
+    // Layer restoration should happen in keycode listener or when sticky key is released
+    if (ev == NULL || !ev->state || active_sticky_mask == 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
 
-        if (current_layer != ZMK_KEYMAP_LAYER_ID_INVAL) {
-            // Get the current binding for this position to see what type it is
-            const struct zmk_behavior_binding *binding =
-                zmk_keymap_get_layer_binding_at_idx(current_layer, ev->position);
-
-            if (binding && binding->behavior_dev) {
-                const char *behavior_name = binding->behavior_dev;
-                LOG_DBG("SKL: position %d binding: %s", ev->position, behavior_name);
-
-                // Switch layers for key-like behaviors that should use the target layer
-                bool is_switchable_behavior = false;
-                
-                // Always switch for regular key presses
-                if (strcmp(behavior_name, "key_press") == 0) {
-                    is_switchable_behavior = true;
-                } else {
-                    // Check for behaviors that are key-like and should switch layers
-                    // This covers tap-dance, hold-tap, and other key-producing behaviors
-                    // Pattern matching for common key-like behavior prefixes/patterns
-                    const char *key_like_patterns[] = {
-                        "ru_",      // Russian tap-dance behaviors 
-                        "en_",      // English tap-dance behaviors 
-                        "es_",      // Spanish tap-dance behaviors 
-                        "td_",      // Common tap-dance prefix
-                        "ht_",      // Hold-tap prefix
-                        "mt_",      // Mod-tap prefix (though mt might be handled elsewhere)
-                    };
-                    
-                    for (int i = 0; i < sizeof(key_like_patterns) / sizeof(key_like_patterns[0]); i++) {
-                        if (strncmp(behavior_name, key_like_patterns[i], strlen(key_like_patterns[i])) == 0) {
-                            is_switchable_behavior = true;
-                            LOG_DBG("SKL: detected key-like behavior: %s (pattern: %s)", 
-                                   behavior_name, key_like_patterns[i]);
-                            break;
-                        }
-                    }
-                }
-                
-                if (is_switchable_behavior) {
-                    // Only switch to English if we're currently on a language layer (0 or 1)
-                    // Don't switch if we're on function layers (7, etc.) - keep those keys on the
-                    // function layer
-                    if (current_layer <= 1) {
-                        LOG_DBG("SKL: intercepting position %d, switching to layer %d before "
-                                "keymap lookup (current layer: %d)",
-                                ev->position, target_layer_key->target_layer, current_layer);
-                        // Save the layer state ONLY if we haven't already saved it
-                        if (target_layer_key->saved_layer_state == 0) {
-                            target_layer_key->saved_layer_state = zmk_keymap_layer_state();
-                            LOG_DBG("SKL: saved layer state: 0x%llx", target_layer_key->saved_layer_state);
-                        }
-                        zmk_keymap_layer_to(target_layer_key->target_layer);
-                        LOG_DBG("SKL: position %d will use sticky key at pos %d for layer %d",
-                                ev->position, target_layer_key->position,
-                                target_layer_key->target_layer);
-                    } else {
-                        LOG_DBG("SKL: skipping layer switch for position %d (on function layer %d)",
-                                ev->position, current_layer);
-                    }
-                } else {
-                    LOG_DBG("SKL: skipping layer switch for position %d (behavior: %s)",
-                            ev->position, behavior_name);
-                }
-            } else {
-                LOG_DBG("SKL: no binding found for position %d on layer %d", ev->position,
-                        current_layer);
-            }
-        } else {
-            LOG_DBG("SKL: no active layer found for position %d", ev->position);
+    struct active_sticky_key *target_layer_key = find_intercepting_sticky_key(ev);
+    // Virtual layer presses are left to the listener right before the keymap
+    if (target_layer_key != NULL && !target_layer_key->config->virtual_layer) {
+        LOG_DBG("SKL: intercepting position %d, switching to layer %d before "
+                "keymap lookup (current layer: %d)",
+                ev->position, target_layer_key->config->target_layer, highest_active_layer);
+        // Save the layer state ONLY if we haven't already saved it
+        if (target_layer_key->saved_layer_state == 0) {
+            target_layer_key->saved_layer_state = zmk_keymap_layer_state();
+            LOG_DBG("SKL: saved layer state: 0x%llx", target_layer_key->saved_layer_state);
         }
+        apply_layer_state(BIT(target_layer_key->config->target_layer));
+        target_layer_key->config->stats->sticky_interceptions++;
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_STICKY_INTERCEPT, ev->position);
+        LOG_DBG("SKL: position %d will use sticky key at pos %d for layer %d", ev->position,
+                target_layer_key->position, target_layer_key->config->target_layer);
     }
 
+    check_sticky_invariants();
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-ZMK_LISTENER(behavior_sticky_key_layer_position, sticky_key_position_state_changed_listener);
+/*
+ * Presses the target layer binding of a virtual-layer sticky key in place of the keymap lookup.
+ * Listeners run in the order of their names: this one sorts after `combo`, so combos and hold-taps
+ * still see intercepted positions, and right before `keymap`, whose lookup it replaces for both the
+ * press and the paired release.
+ */
+static int sticky_key_virtual_layer_listener(const zmk_event_t *eh) {
+    struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    if (!ev->state) {
+        return virtual_press_mask == 0 ? ZMK_EV_EVENT_BUBBLE : release_virtual_layer_press(ev);
+    }
+    if (active_sticky_mask == 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    struct active_sticky_key *target_layer_key = find_intercepting_sticky_key(ev);
+    int ret = ZMK_EV_EVENT_BUBBLE;
+    if (target_layer_key != NULL && target_layer_key->config->virtual_layer &&
+        press_virtual_layer_binding(ev, target_layer_key->config->target_layer)) {
+        // The layer state is never touched so there is nothing to restore once the sticky key is
+        // consumed
+        target_layer_key->config->stats->sticky_interceptions++;
+        zmk_language_trace(ZMK_LANGUAGE_TRACE_STICKY_INTERCEPT, ev->position);
+        ret = ZMK_EV_EVENT_HANDLED;
+    }
+    check_sticky_invariants();
+    return ret;
+}
+
+ZMK_LANGUAGE_LISTENER(intercept_sticky_key_layer, sticky_key_virtual_layer_listener);
+ZMK_SUBSCRIPTION(intercept_sticky_key_layer, zmk_position_state_changed);
+
+ZMK_LANGUAGE_LISTENER(behavior_sticky_key_layer_position,
+                      sticky_key_position_state_changed_listener);
 ZMK_SUBSCRIPTION(behavior_sticky_key_layer_position, zmk_position_state_changed);
 
-void behavior_sticky_key_layer_timer_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
-    struct active_sticky_key *sticky_key =
-        CONTAINER_OF(d_work, struct active_sticky_key, release_timer);
-    if (sticky_key->position == ZMK_BHV_STICKY_KEY_POSITION_FREE) {
-        return;
+static int sticky_key_layer_state_changed_listener(const zmk_event_t *eh) {
+    if (as_zmk_layer_state_changed(eh) != NULL) {
+        update_highest_active_layer();
     }
-    if (sticky_key->timer_cancelled) {
-        sticky_key->timer_cancelled = false;
-    } else {
-        on_sticky_key_timeout(sticky_key);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LANGUAGE_LISTENER(behavior_sticky_key_layer_layers,
+                      sticky_key_layer_state_changed_listener);
+ZMK_SUBSCRIPTION(behavior_sticky_key_layer_layers, zmk_layer_state_changed);
+#endif
+
+static void behavior_sticky_key_layer_timer_handler(struct k_work *item) {
+    const int64_t now = k_uptime_get();
+    uint32_t expired = 0;
+    for (uint32_t slots = release_pending_mask; slots != 0; slots &= slots - 1) {
+        const int i = __builtin_ctz(slots);
+        if (active_sticky_keys[i].release_at <= now) {
+            expired |= BIT(i);
+        }
+    }
+
+    release_pending_mask &= ~expired;
+    for (; expired != 0; expired &= expired - 1) {
+        struct active_sticky_key *sticky_key = &active_sticky_keys[__builtin_ctz(expired)];
+        if (sticky_key->position != ZMK_BHV_STICKY_KEY_POSITION_FREE) {
+            on_sticky_key_timeout(sticky_key);
+        }
     }
+    schedule_release_timer();
+    check_sticky_invariants();
 }
 
 static int behavior_sticky_key_layer_init(const struct device *dev) {
+    const struct behavior_sticky_key_config *config = dev->config;
+    zmk_language_stats_register(dev->name, config->stats);
+
     static bool init_first_run = true;
     if (init_first_run) {
+        k_work_init_delayable(&release_timer, behavior_sticky_key_layer_timer_handler);
         for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-            k_work_init_delayable(&active_sticky_keys[i].release_timer,
-                                  behavior_sticky_key_layer_timer_handler);
             active_sticky_keys[i].position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+            virtual_layer_presses[i].position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+#endif
         }
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_STICKY_KEY_LAYER_INTERCEPTION)
+        update_highest_active_layer();
+#endif
     }
     init_first_run = false;
     return 0;
@@ -600,13 +841,19 @@ struct behavior_sticky_key_data {};
 static struct behavior_sticky_key_data behavior_sticky_key_layer_data;
 
 #define SKL_INST(n)                                                                                \
+    SKL_INTERCEPTION_TABLE(n)                                                                      \
+    static struct zmk_language_stats behavior_sticky_key_layer_stats_##n = {};                     \
     static const struct behavior_sticky_key_config behavior_sticky_key_layer_config_##n = {        \
         .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, DT_DRV_INST(n)),                                 \
         .target_layer = DT_INST_PROP(n, target_layer),                                             \
+        .stats = &behavior_sticky_key_layer_stats_##n,                                             \
+        SKL_INTERCEPTION_CONFIG(n)                                                                 \
         .release_after_ms = DT_INST_PROP(n, release_after_ms),                                     \
         .quick_release = DT_INST_PROP(n, quick_release),                                           \
         .lazy = DT_INST_PROP(n, lazy),                                                             \
         .ignore_modifiers = DT_INST_PROP(n, ignore_modifiers),                                     \
+        .is_key_press = DT_DEP_ORD(DT_INST_PHANDLE_BY_IDX(n, bindings, 0)) ==                      \
+                        DT_DEP_ORD(SKL_KEY_PRESS_NODE),                                            \
     };                                                                                             \
     BEHAVIOR_DT_INST_DEFINE(                                                                       \
         n, behavior_sticky_key_layer_init, NULL, &behavior_sticky_key_layer_data,                  \
@@ -1,5 +1,268 @@
 #include <zmk/language.h>
 
 #include <stdint.h>
+#include <string.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
 
-uint8_t zmk_language_state() { return current_language_state; }
\ No newline at end of file
+#include <zmk/events/language_state_changed.h>
+
+LOG_MODULE_REGISTER(zmk_language, CONFIG_ZMK_LANGUAGE_LOG_LEVEL);
+
+#define ZMK_LANGUAGE_PER_ENDPOINT                                                                  \
+    (!IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL))
+
+// Split peripherals only mirror the central's state, which is not persisted there
+#define ZMK_LANGUAGE_PERSIST (IS_ENABLED(CONFIG_SETTINGS) && ZMK_LANGUAGE_PER_ENDPOINT)
+
+#if ZMK_LANGUAGE_PERSIST
+#include <zephyr/settings/settings.h>
+#endif
+
+#if ZMK_LANGUAGE_PER_ENDPOINT
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/language_trace.h>
+
+// Every host keeps its own active layout, so the language is tracked per endpoint
+#define ZMK_LANGUAGE_STATES_LEN ZMK_ENDPOINT_COUNT
+#else
+#define ZMK_LANGUAGE_STATES_LEN 1
+#endif
+
+static uint8_t language_states[ZMK_LANGUAGE_STATES_LEN] = {};
+static uint8_t current_state_index = 0;
+static uint8_t language_count = UINT8_MAX;
+
+// One entry per instance of the behaviors that keep counters
+#define ZMK_LANGUAGE_STATS_LEN                                                                     \
+    (DT_NUM_INST_STATUS_OKAY(zmk_behavior_lang_switch) +                                           \
+     DT_NUM_INST_STATUS_OKAY(zmk_behavior_kp_on_lang) +                                            \
+     DT_NUM_INST_STATUS_OKAY(zmk_behavior_sticky_key_layer))
+
+struct language_stats_entry {
+    const char *name;
+    struct zmk_language_stats *stats;
+};
+
+static struct language_stats_entry language_stats[MAX(ZMK_LANGUAGE_STATS_LEN, 1)] = {};
+static uint8_t language_stats_len = 0;
+
+uint8_t zmk_language_state() { return language_states[current_state_index]; }
+
+// Stale states, e.g. saved with more languages configured, would make the switch planning run
+// past the end of the language cycle
+static void clamp_language_states(void) {
+    for (int i = 0; i < ZMK_LANGUAGE_STATES_LEN; i++) {
+        if (language_states[i] >= language_count) {
+            LOG_WRN("LANG resetting out of range language %d of endpoint %d", language_states[i],
+                    i);
+            language_states[i] = 0;
+        }
+    }
+}
+
+#if ZMK_LANGUAGE_PERSIST
+static uint8_t saved_language_states[ZMK_LANGUAGE_STATES_LEN] = {};
+
+static void language_save_work_handler(struct k_work *work) {
+    if (memcmp(saved_language_states, language_states, sizeof(language_states)) == 0) {
+        return;
+    }
+    if (settings_save_one("lang/states", language_states, sizeof(language_states)) == 0) {
+        memcpy(saved_language_states, language_states, sizeof(language_states));
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(language_save_work, language_save_work_handler);
+
+static int language_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                 void *cb_arg) {
+    const char *next;
+    if (settings_name_steq(name, "states", &next) && !next) {
+        if (len != sizeof(language_states)) {
+            return -EINVAL;
+        }
+        int rc = read_cb(cb_arg, language_states, sizeof(language_states));
+        if (rc < 0) {
+            return rc;
+        }
+        memcpy(saved_language_states, language_states, sizeof(language_states));
+        clamp_language_states();
+        return 0;
+    }
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(lang, "lang", NULL, language_settings_set, NULL, NULL);
+#endif
+
+void zmk_language_set_state(uint8_t lang) {
+    if (language_states[current_state_index] == lang) {
+        return;
+    }
+    language_states[current_state_index] = lang;
+#if ZMK_LANGUAGE_PERSIST
+    // Debounced so that rapid switching results in at most one flash write
+    k_work_reschedule(&language_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+#endif
+    raise_language_state_changed(lang);
+}
+
+void zmk_language_limit_count(uint8_t count) {
+    language_count = MIN(language_count, count);
+    clamp_language_states();
+}
+
+int zmk_language_load_state() {
+#if ZMK_LANGUAGE_PERSIST
+    static bool loaded = false;
+    if (loaded) {
+        return 0;
+    }
+    loaded = true;
+    settings_subsys_init();
+    return settings_load_subtree("lang");
+#else
+    return 0;
+#endif
+}
+
+void zmk_language_stats_register(const char *name, struct zmk_language_stats *stats) {
+    if (language_stats_len == ARRAY_SIZE(language_stats)) {
+        LOG_ERR("LANG no room for the counters of %s", name);
+        return;
+    }
+    language_stats[language_stats_len++] = (struct language_stats_entry){
+        .name = name,
+        .stats = stats,
+    };
+}
+
+void zmk_language_stats_reset() {
+    for (int i = 0; i < language_stats_len; i++) {
+        memset(language_stats[i].stats, 0, sizeof(struct zmk_language_stats));
+    }
+}
+
+#if ZMK_LANGUAGE_PER_ENDPOINT
+static int language_endpoint_changed_listener(const zmk_event_t *eh) {
+    const struct zmk_endpoint_changed *ev = as_zmk_endpoint_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const int index = zmk_endpoint_instance_to_index(ev->endpoint);
+    if (index < 0 || index >= ZMK_LANGUAGE_STATES_LEN || index == current_state_index) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    const uint8_t previous = zmk_language_state();
+    current_state_index = index;
+    clamp_language_states();
+    LOG_DBG("LANG endpoint %d selected, language %d", index, zmk_language_state());
+    if (zmk_language_state() != previous) {
+        raise_language_state_changed(zmk_language_state());
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LANGUAGE_LISTENER(language, language_endpoint_changed_listener);
+ZMK_SUBSCRIPTION(language, zmk_endpoint_changed);
+#endif
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+
+static void print_stat(const struct shell *sh, const char *prefix, const char *name,
+                       uint32_t value) {
+    shell_print(sh, "%s%s: %u", prefix, name, value);
+}
+
+// Prints the counters of one instance, or the totals of all instances when name is NULL
+static void print_stats(const struct shell *sh, const char *name,
+                        const struct zmk_language_stats *stats) {
+    const char *prefix = name != NULL ? "  " : "";
+    if (name != NULL) {
+        shell_print(sh, "%s:", name);
+    }
+    // Instances only print the counters of their own behavior
+    if (name == NULL || stats->switches != 0 || stats->injected_taps != 0) {
+        print_stat(sh, prefix, "switches", stats->switches);
+        print_stat(sh, prefix, "injected_taps", stats->injected_taps);
+    }
+    if (name == NULL || stats->kp_on_lang_switches != 0 || stats->kp_on_lang_remaps != 0) {
+        print_stat(sh, prefix, "kp_on_lang_switches", stats->kp_on_lang_switches);
+        print_stat(sh, prefix, "kp_on_lang_remaps", stats->kp_on_lang_remaps);
+    }
+    if (name == NULL || stats->sticky_interceptions != 0 || stats->sticky_layer_restores != 0) {
+        print_stat(sh, prefix, "sticky_interceptions", stats->sticky_interceptions);
+        print_stat(sh, prefix, "sticky_layer_restores", stats->sticky_layer_restores);
+    }
+}
+
+static int cmd_lang_stats(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_language_stats total = {};
+    for (int i = 0; i < language_stats_len; i++) {
+        const struct zmk_language_stats *stats = language_stats[i].stats;
+        total.switches += stats->switches;
+        total.injected_taps += stats->injected_taps;
+        total.kp_on_lang_switches += stats->kp_on_lang_switches;
+        total.kp_on_lang_remaps += stats->kp_on_lang_remaps;
+        total.sticky_interceptions += stats->sticky_interceptions;
+        total.sticky_layer_restores += stats->sticky_layer_restores;
+    }
+
+    shell_print(sh, "uptime_ms: %lld", (long long)k_uptime_get());
+    shell_print(sh, "language: %d", zmk_language_state());
+    print_stats(sh, NULL, &total);
+    for (int i = 0; i < language_stats_len; i++) {
+        print_stats(sh, language_stats[i].name, language_stats[i].stats);
+    }
+    return 0;
+}
+
+static int cmd_lang_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    zmk_language_stats_reset();
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_LANGUAGE_TRACE)
+#include <zmk/language_trace.h>
+
+// Prints the trace as CSV for scripts/lang_trace_analyze.py, `lang trace clear` empties it
+static int cmd_lang_trace(const struct shell *sh, size_t argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "clear") != 0) {
+            shell_error(sh, "Unknown argument: %s", argv[1]);
+            return -EINVAL;
+        }
+        zmk_language_trace_clear();
+        return 0;
+    }
+
+    shell_print(sh, "timestamp_us,type,position,language,layer");
+    for (size_t i = 0; i < zmk_language_trace_count(); i++) {
+        const struct zmk_language_trace_record *record = zmk_language_trace_at(i);
+        shell_print(sh, "%u,%u,%u,%u,%u", record->timestamp_us, record->type, record->position,
+                    record->language, record->layer);
+    }
+    return 0;
+}
+
+#define LANG_TRACE_CMD                                                                             \
+    SHELL_CMD_ARG(trace, NULL, "Print or clear the language trace buffer", cmd_lang_trace, 1, 1),
+#else
+#define LANG_TRACE_CMD
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_lang,
+                               SHELL_CMD(stats, NULL, "Print language switching counters",
+                                         cmd_lang_stats),
+                               SHELL_CMD(reset, NULL, "Reset language switching counters",
+                                         cmd_lang_stats_reset),
+                               LANG_TRACE_CMD SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(lang, &sub_lang, "Language switching commands", NULL);
+#endif
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/language_trace.h>
+
+#include <zephyr/kernel.h>
+
+#include <zmk/keymap.h>
+#include <zmk/language.h>
+
+// Records are written in place from the event and work queue paths, never formatted on device
+static struct zmk_language_trace_record trace_records[CONFIG_ZMK_LANGUAGE_TRACE_SIZE];
+// Total number of records written, the ring holds the last CONFIG_ZMK_LANGUAGE_TRACE_SIZE
+static uint32_t trace_written;
+
+void zmk_language_trace(enum zmk_language_trace_type type, uint32_t position) {
+    struct zmk_language_trace_record *record =
+        &trace_records[trace_written % CONFIG_ZMK_LANGUAGE_TRACE_SIZE];
+    record->timestamp_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+    record->position = position;
+    record->type = type;
+    record->language = zmk_language_state();
+    record->layer = zmk_keymap_highest_layer_active();
+    trace_written++;
+}
+
+size_t zmk_language_trace_count() { return MIN(trace_written, CONFIG_ZMK_LANGUAGE_TRACE_SIZE); }
+
+const struct zmk_language_trace_record *zmk_language_trace_at(size_t index) {
+    const uint32_t oldest = trace_written - zmk_language_trace_count();
+    return &trace_records[(oldest + index) % CONFIG_ZMK_LANGUAGE_TRACE_SIZE];
+}
+
+void zmk_language_trace_clear() { trace_written = 0; }
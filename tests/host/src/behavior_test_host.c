@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_test_host
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/printk.h>
+#include <drivers/behavior.h>
+
+#include <zmk/behavior.h>
+#include <zmk/endpoints.h>
+#include <zmk/hid.h>
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+#include <zmk/hid_indicators.h>
+#endif
+
+/*
+ * Stands in for the host side of the tests: param1 values below HOST_CHECK are indicator LED
+ * states the host reports for the selected endpoint, as it does after a layout change of its own.
+ * HOST_CHECK prints whether any key or modifier is still down in the keyboard report.
+ */
+#define HOST_CHECK 0x100
+
+static int behavior_test_host_init(const struct device *dev) { return 0; };
+
+static int test_host_binding_pressed(struct zmk_behavior_binding *binding,
+                                     struct zmk_behavior_binding_event event) {
+    if (binding->param1 == HOST_CHECK) {
+        static const struct zmk_hid_keyboard_report_body empty = {};
+        const bool idle =
+            memcmp(&zmk_hid_get_keyboard_report()->body, &empty, sizeof(empty)) == 0;
+        printk("test_host: keyboard report %s\n", idle ? "empty" : "not empty");
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    struct zmk_hid_led_report_body report = {
+        .leds = binding->param1,
+    };
+    zmk_hid_indicators_process_report(&report, zmk_endpoints_selected());
+#endif
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int test_host_binding_released(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_test_host_driver_api = {
+    .binding_pressed = test_host_binding_pressed,
+    .binding_released = test_host_binding_released};
+
+BEHAVIOR_DT_INST_DEFINE(0, behavior_test_host_init, NULL, NULL, NULL, APPLICATION,
+                        CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_test_host_driver_api);
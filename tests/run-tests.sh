@@ -0,0 +1,127 @@
+#!/usr/bin/env bash
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+#
+# Builds every test case (a directory holding a native_sim.keymap) as a ZMK firmware for native_sim
+# with this module and the fake host in tests/host, runs it and compares the events picked out by
+# the case's events.patterns with its keycode_events.snapshot, like ZMK's own app/run-test.sh.
+#
+# Every case also prints BENCH,<case>,<metric>,<value> lines: keycode reports sent to the host,
+# injected language hotkey taps, the time from the first to the last report, and the calls, total
+# and worst-case cycles of each listener of the module. They are collected in
+# $BUILD_ROOT/bench.csv. Metrics listed in a case's bench.expect as `<metric> <min> <max>` must lie
+# within those bounds.
+#
+#     tests/run-tests.sh <path to zmk/app> [test case directory...]
+
+set -u
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 <path to zmk/app> [test case directory...]" >&2
+    exit 2
+fi
+
+zmk_app=$(realpath "$1")
+shift
+tests_dir=$(dirname "$(realpath "$0")")
+module_dir=$(dirname "$tests_dir")
+board=${BOARD:-native_sim/native/64}
+build_root=${BUILD_ROOT:-$module_dir/build/tests}
+
+if [ $# -eq 0 ]; then
+    set -- $(find "$tests_dir" -name native_sim.keymap -printf '%h\n' | sort)
+fi
+
+bench() {
+    awk -v name="$1" '
+        /hid_listener_keycode_(pressed|released):/ {
+            reports++
+            if (/pressed:.* keycode 0x6[89] /) {
+                injected++
+            }
+            if (match($0, /^\[[0-9]+:[0-9]+:[0-9]+\.[0-9]+,[0-9]+\]/)) {
+                split(substr($0, 2, RLENGTH - 2), t, /[:.,]/)
+                ms = ((t[1] * 60 + t[2]) * 60 + t[3]) * 1000 + t[4]
+                if (first == "") {
+                    first = ms
+                }
+                last = ms
+            }
+        }
+        /^lang_listener,/ {
+            split($0, f, ",")
+            calls[f[2]]++
+            total[f[2]] += f[3]
+            if (f[3] > max[f[2]]) {
+                max[f[2]] = f[3]
+            }
+        }
+        END {
+            printf "BENCH,%s,keycode_reports,%d\n", name, reports
+            printf "BENCH,%s,injected_taps,%d\n", name, injected
+            if (first != "") {
+                printf "BENCH,%s,duration_ms,%d\n", name, last - first
+            }
+            for (l in calls) {
+                printf "BENCH,%s,listener.%s.calls,%d\n", name, l, calls[l]
+                printf "BENCH,%s,listener.%s.total_cycles,%d\n", name, l, total[l]
+                printf "BENCH,%s,listener.%s.max_cycles,%d\n", name, l, max[l]
+            }
+        }' "$2" | sort
+}
+
+check_bench() {
+    local status=0 metric min max value
+    while read -r metric min max; do
+        case "$metric" in "" | "#"*) continue ;; esac
+        value=$(awk -F, -v m="$metric" '$3 == m { print $4 }' "$2")
+        if [ -z "$value" ] || [ "$value" -lt "$min" ] || [ "$value" -gt "$max" ]; then
+            echo "  $metric is ${value:-missing}, expected $min..$max"
+            status=1
+        fi
+    done <"$1"
+    return $status
+}
+
+mkdir -p "$build_root"
+: >"$build_root/bench.csv"
+failed=0
+for case_dir in "$@"; do
+    case_dir=$(realpath "$case_dir")
+    name=${case_dir#"$tests_dir"/}
+    build_dir=$build_root/$name
+    mkdir -p "$build_dir"
+
+    if ! west build -p -s "$zmk_app" -d "$build_dir" -b "$board" -- \
+        -DZMK_CONFIG="$case_dir" -DZMK_EXTRA_MODULES="$module_dir;$tests_dir/host" \
+        -DEXTRA_CONF_FILE="$tests_dir/native_sim.conf" -DCONFIG_ASSERT=y \
+        >"$build_dir/build.log" 2>&1; then
+        echo "FAILED: $name did not build, see $build_dir/build.log"
+        failed=1
+        continue
+    fi
+
+    timeout 120 "$build_dir/zephyr/zmk.exe" >"$build_dir/keycode_events.full.log" 2>&1
+    status=$?
+    sed -n -f "$case_dir/events.patterns" "$build_dir/keycode_events.full.log" \
+        >"$build_dir/keycode_events.log"
+    bench "$name" "$build_dir/keycode_events.full.log" | tee "$build_dir/bench.csv" \
+        >>"$build_root/bench.csv"
+
+    if [ $status -ne 0 ]; then
+        echo "FAILED: $name exited with status $status, see $build_dir/keycode_events.full.log"
+        failed=1
+    elif ! diff -au "$case_dir/keycode_events.snapshot" "$build_dir/keycode_events.log"; then
+        echo "FAILED: $name"
+        failed=1
+    elif [ -f "$case_dir/bench.expect" ] &&
+        ! check_bench "$case_dir/bench.expect" "$build_dir/bench.csv"; then
+        echo "FAILED: $name benchmark out of bounds"
+        failed=1
+    else
+        echo "PASS: $name"
+    fi
+done
+
+cat "$build_root/bench.csv"
+exit $failed
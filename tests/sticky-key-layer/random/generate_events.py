@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""Event list for the randomized sticky-key-layer case.
+
+Writes a seeded random sequence of presses and releases of the plain, press-on-lang, momentary
+layer and sticky keys in native_sim.keymap, with short pauses and pauses across the sticky key
+timeout, followed by the release of every key still held. The checked-in events.dtsi is
+generated with the defaults; pass a larger --steps for a longer local run.
+
+    python3 generate_events.py --seed 1 --steps 400 > events.dtsi
+"""
+
+import argparse
+
+# Positions of native_sim.keymap taking part: &kp, &kp, &kp_ru, &mo, &skl and &vskl
+POSITIONS = (0, 1, 2, 3, 4, 5)
+COLUMNS = 4
+
+
+def xorshift32(state):
+    state ^= (state << 13) & 0xFFFFFFFF
+    state ^= state >> 17
+    state ^= (state << 5) & 0xFFFFFFFF
+    return state
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--steps", type=int, default=400)
+    args = parser.parse_args()
+
+    state = args.seed or 1
+
+    def rand(n):
+        nonlocal state
+        state = xorshift32(state)
+        return state % n
+
+    def event(kind, position, ms):
+        return f"ZMK_MOCK_{kind}({position // COLUMNS},{position % COLUMNS},{ms})"
+
+    held = set()
+    events = []
+    for _ in range(args.steps):
+        position = POSITIONS[rand(len(POSITIONS))]
+        # Mostly quick typing, every fourth step waits past release-after-ms
+        ms = 1 + rand(40) if rand(4) else 150 + rand(111)
+        if position in held:
+            held.remove(position)
+            events.append(event("RELEASE", position, ms))
+        else:
+            held.add(position)
+            events.append(event("PRESS", position, ms))
+    for position in sorted(held):
+        events.append(event("RELEASE", position, 10))
+
+    print(f"/* Generated by generate_events.py --seed {args.seed} --steps {args.steps} */")
+    for e in events:
+        print(e)
+
+
+if __name__ == "__main__":
+    main()